@@ -0,0 +1,261 @@
+#ifndef ROSSB83_ALLOCATION_COUNTER_HPP
+#define ROSSB83_ALLOCATION_COUNTER_HPP
+
+#include <atomic>
+#include <string>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include <sys/resource.h>
+
+// ben's namespace
+namespace rossb83 {
+
+/*
+ * counts heap allocations made through operator new, so the allocations and bytes of every phase
+ * of a program (parse, insert, build, serialize, query) can be measured and regressions caught
+ *
+ * counting is opt in, a program turns it on by defining ROSSB83_COUNT_ALLOCATIONS in exactly one
+ * translation unit before including this header, which replaces the global operator new and
+ * delete with ones that keep each block's size in front of it, without it every counter stays
+ * at zero and enabled() is false
+ *
+ * counters are relaxed atomics, so counting costs two atomic adds per allocation and is safe
+ * from any thread, the counts of a phase include every thread allocating meanwhile
+ */
+class AllocationCounter {
+
+    public:
+
+    /*
+     * helper nested struct - counters at one moment
+     */
+    struct Snapshot {
+
+        /*
+         * number of allocations ever made
+         */
+        std::size_t allocations_;
+
+        /*
+         * bytes ever allocated
+         */
+        std::size_t bytes_;
+
+        /*
+         * bytes allocated and not yet freed
+         */
+        std::size_t liveBytes_;
+
+        /*
+         * highest liveBytes_ since the last resetPeak()
+         */
+        std::size_t peakBytes_;
+
+    }; // struct Snapshot
+
+    /*
+     * getter - true iff operator new is counted in this program
+     */
+    static bool enabled() {return enabled_;}
+
+    /*
+     * getter - current counters
+     */
+    static Snapshot snapshot() {
+
+        return {allocations_.load(std::memory_order_relaxed), bytes_.load(std::memory_order_relaxed),
+                liveBytes_.load(std::memory_order_relaxed), peakBytes_.load(std::memory_order_relaxed)};
+    }
+
+    /*
+     * starts measuring the peak again from the bytes live now
+     */
+    static void resetPeak() {peakBytes_.store(liveBytes_.load(std::memory_order_relaxed), std::memory_order_relaxed);}
+
+    /*
+     * getter - peak resident memory of the whole process in bytes, as reported by the os, never
+     * goes down and also counts memory not allocated through operator new such as mapped files
+     */
+    static std::size_t residentPeak() {
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+
+        // linux reports kilobytes
+        return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+    }
+
+    /*
+     * hook called by operator new for every block allocated
+     */
+    static void allocated(const std::size_t& size) {
+
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        bytes_.fetch_add(size, std::memory_order_relaxed);
+
+        std::size_t live = liveBytes_.fetch_add(size, std::memory_order_relaxed) + size;
+        std::size_t peak = peakBytes_.load(std::memory_order_relaxed);
+
+        while (live > peak && !peakBytes_.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    }
+
+    /*
+     * hook called by operator delete for every block freed
+     */
+    static void deallocated(const std::size_t& size) {liveBytes_.fetch_sub(size, std::memory_order_relaxed);}
+
+    /*
+     * marks operator new as counted, called once when it is replaced before main runs
+     */
+    static bool enable() {return enabled_ = true;}
+
+    private:
+
+    static inline bool enabled_ = false;
+
+    static inline std::atomic<std::size_t> allocations_{0};
+    static inline std::atomic<std::size_t> bytes_{0};
+    static inline std::atomic<std::size_t> liveBytes_{0};
+    static inline std::atomic<std::size_t> peakBytes_{0};
+
+}; // class AllocationCounter
+
+/*
+ * allocations of one phase of a program, measured from construction to report()
+ */
+class AllocationPhase {
+
+    public:
+
+    /*
+     * helper nested struct - what a phase allocated
+     */
+    struct Report {
+
+        /*
+         * name of the phase
+         */
+        std::string name_;
+
+        /*
+         * number of allocations made during the phase
+         */
+        std::size_t allocations_;
+
+        /*
+         * bytes allocated during the phase, freed or not
+         */
+        std::size_t bytes_;
+
+        /*
+         * most bytes live at once during the phase above those live when it started
+         */
+        std::size_t peakBytes_;
+
+        /*
+         * peak resident memory of the process at the end of the phase
+         */
+        std::size_t residentPeak_;
+
+    }; // struct Report
+
+    /*
+     * ctor starts measuring a phase
+     * input name - name of the phase
+     */
+    AllocationPhase(const std::string& name) : name_(name) {
+
+        AllocationCounter::resetPeak();
+        start_ = AllocationCounter::snapshot();
+    }
+
+    /*
+     * counters from the start of the phase until now
+     */
+    Report report() const {
+
+        AllocationCounter::Snapshot now = AllocationCounter::snapshot();
+
+        return {name_, now.allocations_ - start_.allocations_, now.bytes_ - start_.bytes_,
+                now.peakBytes_ - start_.liveBytes_, AllocationCounter::residentPeak()};
+    }
+
+    private:
+
+    /*
+     * name of the phase
+     */
+    std::string name_;
+
+    /*
+     * counters when the phase started
+     */
+    AllocationCounter::Snapshot start_;
+
+}; // class AllocationPhase
+
+} // namespace rossb83
+
+#ifdef ROSSB83_COUNT_ALLOCATIONS
+
+namespace rossb83 {
+
+/*
+ * size of the header in front of every counted block, keeps blocks aligned for any type
+ */
+static const std::size_t ALLOCATION_HEADER = alignof(std::max_align_t);
+
+static const bool ALLOCATION_COUNTER_ENABLED = AllocationCounter::enable();
+
+} // namespace rossb83
+
+void* operator new(std::size_t size) {
+
+    void* block = std::malloc(size + rossb83::ALLOCATION_HEADER);
+
+    if (!block) throw std::bad_alloc();
+
+    // the size is kept in front of the block so delete knows how many bytes are freed
+    *static_cast<std::size_t*>(block) = size;
+    rossb83::AllocationCounter::allocated(size);
+
+    return static_cast<char*>(block) + rossb83::ALLOCATION_HEADER;
+}
+
+void* operator new[](std::size_t size) {return operator new(size);}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+
+    try {
+        return operator new(size);
+    } catch (const std::bad_alloc& e) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {return operator new(size, tag);}
+
+void operator delete(void* p) noexcept {
+
+    if (!p) return;
+
+    char* block = static_cast<char*>(p) - rossb83::ALLOCATION_HEADER;
+
+    rossb83::AllocationCounter::deallocated(*reinterpret_cast<std::size_t*>(block));
+    std::free(block);
+}
+
+void operator delete[](void* p) noexcept {operator delete(p);}
+
+void operator delete(void* p, std::size_t) noexcept {operator delete(p);}
+
+void operator delete[](void* p, std::size_t) noexcept {operator delete(p);}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {operator delete(p);}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {operator delete(p);}
+
+#endif // ROSSB83_COUNT_ALLOCATIONS
+
+#endif // ROSSB83_ALLOCATION_COUNTER_HPP
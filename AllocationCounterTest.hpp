@@ -0,0 +1,119 @@
+#ifndef ROSSB83_ALLOCATION_COUNTER_TEST_HPP
+#define ROSSB83_ALLOCATION_COUNTER_TEST_HPP
+
+#include <assert.h>
+
+#include "AllocationCounter.hpp"
+#include "kdtree.hpp"
+
+namespace rossb83 {
+
+ class AllocationCounterTest {
+
+  public:
+
+   AllocationCounterTest() {
+
+    std::cout << "Running Allocation Counter tests..." << std::endl;
+
+    countTest();
+    queryTest();
+    memoryUsageTest();
+   }
+
+  private:
+
+   void countTest() {
+
+    std::cout << "AllocationCounter count test..." << std::endl;
+
+    // the test program counts its allocations
+    assert(AllocationCounter::enabled());
+
+    AllocationPhase phase("vector");
+    AllocationCounter::Snapshot before = AllocationCounter::snapshot();
+
+    {
+     std::vector<int> values(1000);
+     std::vector<int> more(500);
+    }
+
+    AllocationPhase::Report report = phase.report();
+    AllocationCounter::Snapshot after = AllocationCounter::snapshot();
+
+    assert(report.name_ == "vector");
+    assert(report.allocations_ == 2);
+    assert(report.bytes_ == 1500 * sizeof(int));
+    assert(report.peakBytes_ == 1500 * sizeof(int));
+    assert(report.residentPeak_ > 0);
+
+    // everything allocated was freed again
+    assert(after.liveBytes_ == before.liveBytes_);
+   }
+
+   void queryTest() {
+
+    std::cout << "AllocationCounter query test..." << std::endl;
+
+    PCDFile<double> pcd1("sample_data.csv");
+    PCDFile<double> pcd2("query_data.csv");
+
+    KDTree<double> sampleKDTree(pcd1);
+    std::vector<Point<double>> queryPoints(pcd2.begin(), pcd2.end());
+
+    // queries through a context never touch the heap
+    KDTree<double>::QueryContext context(sampleKDTree);
+    AllocationPhase phase("query");
+
+    for (const Point<double>& queryPoint : queryPoints) {
+     sampleKDTree.queryNearestNeighbor(queryPoint, context);
+    }
+
+    assert(phase.report().allocations_ == 0);
+
+    // radius queries into a reused buffer only allocate while the buffer grows on the first call
+    std::vector<std::size_t> neighbors;
+    sampleKDTree.queryRadius(queryPoints.front(), 1.0, neighbors, context);
+    std::size_t found = neighbors.size();
+
+    AllocationPhase radius("radius");
+
+    for (int i = 0; i < 100; i++) {
+     sampleKDTree.queryRadius(queryPoints.front(), 1.0, neighbors, context);
+    }
+
+    assert(radius.report().allocations_ == 0);
+    assert(neighbors.size() == found && found > 0);
+    assert(neighbors.size() == std::get<0>(sampleKDTree.queryRadius(queryPoints.front(), 1.0)).size());
+   }
+
+   void memoryUsageTest() {
+
+    std::cout << "AllocationCounter memory usage test..." << std::endl;
+
+    PCDFile<double> pcd("sample_data.csv");
+
+    auto splitPointStrategy = std::make_shared<SplitPointSortStrategy<double>>();
+    auto splitAxisStrategy = std::make_shared<SplitAxisRoundRobinStrategy<double>>();
+
+    // a built tree holds about what its arrays need, a node, three coordinates and an id per point
+    AllocationPhase phase("build");
+    KDTree<double> sampleKDTree(pcd, splitPointStrategy, splitAxisStrategy);
+    AllocationPhase::Report report = phase.report();
+
+    std::size_t perPoint = sampleKDTree.memoryUsage() / sampleKDTree.points();
+
+    assert(perPoint >= 3 * sizeof(double) + sizeof(std::uint64_t));
+    assert(perPoint <= 80);
+    assert(report.peakBytes_ >= sampleKDTree.memoryUsage() - sizeof(sampleKDTree));
+
+    // buckets cut the node count and so the memory
+    KDTree<double> bucketKDTree(pcd, splitPointStrategy, splitAxisStrategy, 1, 8);
+    assert(bucketKDTree.memoryUsage() < sampleKDTree.memoryUsage());
+   }
+
+ }; // class AllocationCounterTest
+
+} // namespace rossb83
+
+#endif // ROSSB83_ALLOCATION_COUNTER_TEST_HPP
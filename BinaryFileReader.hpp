@@ -0,0 +1,231 @@
+#ifndef ROSSB83_BINARY_FILE_READER_HPP
+#define ROSSB83_BINARY_FILE_READER_HPP
+
+#include <string>
+#include <memory>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+
+#include "MappedFile.hpp"
+
+// ben's namespace
+namespace rossb83 {
+
+/*
+ * fixed size header at the start of a binary kdtree file
+ *
+ * the header is followed by sections holding the arrays of the tree exactly as they are laid out
+ * in memory, in native byte order and each starting on a 64 byte boundary:
+ *
+ *     bounds         - min then max corner of the smallest cell containing every point, 2*dims values
+ *     nodes          - node array in preorder, each node holds a range of points
+ *     coordinates    - dims values per point, points in inorder
+ *     ids            - id of every point, points in inorder
+ *
+ * so a reader can map the file and point straight into it
+ */
+struct BinaryFileHeader {
+
+    /*
+     * identifies the file as a binary kdtree, "KDTREE" padded with nulls
+     */
+    char magic_[8];
+
+    /*
+     * format version, bumped whenever the layout of the file changes
+     */
+    std::uint32_t version_;
+
+    /*
+     * BYTE_ORDER_MARK as written by the host that wrote the file, reads back differently on a host of other endianness
+     */
+    std::uint32_t byteOrder_;
+
+    /*
+     * kind and size of the coordinate type, see scalarType()
+     */
+    std::uint32_t scalarType_;
+
+    /*
+     * arrangement of the node array, only LAYOUT_PREORDER so far
+     */
+    std::uint32_t layout_;
+
+    /*
+     * size in bytes of one node
+     */
+    std::uint32_t nodeSize_;
+
+    /*
+     * largest number of points stored in one leaf
+     */
+    std::uint32_t bucketSize_;
+
+    /*
+     * dimensionality of the points
+     */
+    std::uint64_t dims_;
+
+    /*
+     * number of points
+     */
+    std::uint64_t points_;
+
+    /*
+     * number of nodes, at most the number of points
+     */
+    std::uint64_t nodes_;
+
+    /*
+     * index of the root node, all bits set for an empty tree
+     */
+    std::uint64_t root_;
+
+    /*
+     * number of nodes on the longest path from the root to a leaf, sizes query stacks without walking the nodes
+     */
+    std::uint64_t height_;
+
+    /*
+     * byte offsets of the sections from the start of the file
+     */
+    std::uint64_t boundsOffset_;
+    std::uint64_t nodesOffset_;
+    std::uint64_t coordinatesOffset_;
+    std::uint64_t idsOffset_;
+
+    /*
+     * size of the whole file, catches truncated files
+     */
+    std::uint64_t fileSize_;
+
+    static const std::uint32_t VERSION = 4;
+    static const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static const std::uint32_t LAYOUT_PREORDER = 2;
+    static const std::uint64_t ALIGNMENT = 64;
+
+    /*
+     * helper function to compute the magic every file starts with
+     */
+    static const char* magic() {return "KDTREE\0";}
+
+    /*
+     * helper function to encode the coordinate type, kind in the high bits and size in bytes in the low bits
+     */
+    template <typename T>
+    static std::uint32_t scalarType() {
+
+        std::uint32_t kind = std::is_floating_point<T>::value ? 2 : (std::is_signed<T>::value ? 1 : 0);
+        return (kind << 8) | sizeof(T);
+    }
+
+    /*
+     * helper function to round an offset up to the next section boundary
+     */
+    static std::uint64_t align(const std::uint64_t& offset) {
+
+        return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+}; // struct BinaryFileHeader
+
+/*
+ * class that memory maps a binary kdtree file so a kdtree can be queried straight out of the file,
+ * nothing is parsed or copied, pages are read in by the os as the tree touches them
+ */
+template <typename T>
+class BinaryFileReader {
+
+    public:
+
+    /*
+     * ctor maps file with filename and checks its header
+     * input filename - file to be read from
+     */
+    BinaryFileReader(const std::string& filename) : mapping_(std::make_shared<MappedFile>(filename)) {
+
+        if (mapping_->size() < sizeof(BinaryFileHeader)) {
+            throw std::runtime_error(filename + " is too small to be a binary kdtree file");
+        }
+
+        const BinaryFileHeader& h = header();
+
+        if (std::memcmp(h.magic_, BinaryFileHeader::magic(), sizeof(h.magic_)) != 0) {
+            throw std::runtime_error(filename + " is not a binary kdtree file");
+        }
+
+        if (h.version_ != BinaryFileHeader::VERSION) {
+            throw std::runtime_error(filename + " has unsupported binary kdtree version " + std::to_string(h.version_));
+        }
+
+        if (h.byteOrder_ != BinaryFileHeader::BYTE_ORDER_MARK) {
+            throw std::runtime_error(filename + " was written on a host of different byte order");
+        }
+
+        if (h.scalarType_ != BinaryFileHeader::scalarType<T>()) {
+            throw std::runtime_error(filename + " holds coordinates of a different type");
+        }
+
+        if (h.layout_ != BinaryFileHeader::LAYOUT_PREORDER) {
+            throw std::runtime_error(filename + " has unsupported node layout " + std::to_string(h.layout_));
+        }
+
+        if (h.fileSize_ != mapping_->size()) {
+            throw std::runtime_error(filename + " is truncated");
+        }
+    }
+
+    /*
+     * true iff the file exists and starts with the binary kdtree magic
+     * input filename - file to check
+     */
+    static bool isBinaryFile(const std::string& filename) {
+
+        char magic[sizeof(BinaryFileHeader::magic_)] = {};
+        std::ifstream file(filename, std::ios::binary);
+
+        file.read(magic, sizeof(magic));
+
+        return file && std::memcmp(magic, BinaryFileHeader::magic(), sizeof(magic)) == 0;
+    }
+
+    /*
+     * getter - header at the start of the file
+     */
+    const BinaryFileHeader& header() const {return *reinterpret_cast<const BinaryFileHeader*>(mapping_->data());}
+
+    /*
+     * getter - array of count elements starting offset bytes into the file
+     * input offset - section offset from the header
+     * input count - number of elements in the section
+     */
+    template <typename E>
+    const E* section(const std::uint64_t& offset, const std::uint64_t& count) const {
+
+        if (offset % alignof(E) != 0 || offset > mapping_->size() || count > (mapping_->size() - offset) / sizeof(E)) {
+            throw std::runtime_error("binary kdtree file section lies outside the file");
+        }
+
+        return reinterpret_cast<const E*>(mapping_->data() + offset);
+    }
+
+    /*
+     * getter - handle keeping the file mapped, a kdtree reading from the file holds on to it
+     */
+    std::shared_ptr<const void> mapping() const {return mapping_;}
+
+    private:
+
+    /*
+     * mapped file
+     */
+    std::shared_ptr<MappedFile> mapping_;
+
+}; // class BinaryFileReader
+
+} // namespace rossb83
+
+#endif // ROSSB83_BINARY_FILE_READER_HPP
@@ -0,0 +1,131 @@
+#ifndef ROSSB83_BINARY_FILE_WRITER_HPP
+#define ROSSB83_BINARY_FILE_WRITER_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+
+#include "kdtree.hpp"
+#include "BinaryFileReader.hpp"
+
+// ben's namespace
+namespace rossb83 {
+
+/*
+ * class that serializes a kdtree into a compact binary file, the arrays of the tree are written
+ * exactly as they sit in memory so BinaryFileReader can map the file and query it in place,
+ * see BinaryFileHeader for the layout
+ */
+template <typename T>
+class BinaryFileWriter {
+
+    public:
+
+    /*
+     * attach a filename
+     */
+    BinaryFileWriter(const std::string& filename) : filename_(filename) {}
+
+    /*
+     * writes the header followed by the bounds, node, coordinate and id sections of a kdtree
+     */
+    template <std::size_t K>
+    void writeFile(const KDTree<T,K>& kdtree) const {
+
+        typedef typename KDTree<T,K>::KDNode KDNode;
+
+        std::uint64_t points = kdtree.points();
+        std::uint64_t nodeCount = kdtree.nodes();
+        std::uint64_t dims = kdtree.dims();
+
+        BinaryFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic_, BinaryFileHeader::magic(), sizeof(header.magic_));
+
+        header.version_ = BinaryFileHeader::VERSION;
+        header.byteOrder_ = BinaryFileHeader::BYTE_ORDER_MARK;
+        header.scalarType_ = BinaryFileHeader::scalarType<T>();
+        header.layout_ = BinaryFileHeader::LAYOUT_PREORDER;
+        header.nodeSize_ = sizeof(KDNode);
+        header.bucketSize_ = kdtree.bucketSize();
+        header.dims_ = dims;
+        header.points_ = points;
+        header.nodes_ = nodeCount;
+        header.root_ = nodeCount ? kdtree.root_ : std::numeric_limits<std::uint64_t>::max();
+        header.height_ = kdtree.height();
+
+        // every section starts on an aligned offset following the previous one
+        header.boundsOffset_ = BinaryFileHeader::align(sizeof(header));
+        header.nodesOffset_ = BinaryFileHeader::align(header.boundsOffset_ + 2 * dims * sizeof(T));
+        header.coordinatesOffset_ = BinaryFileHeader::align(header.nodesOffset_ + nodeCount * sizeof(KDNode));
+        header.idsOffset_ = BinaryFileHeader::align(header.coordinatesOffset_ + points * dims * sizeof(T));
+        header.fileSize_ = header.idsOffset_ + points * sizeof(std::uint64_t);
+
+        std::ofstream file(filename_, std::ios::binary | std::ios::trunc);
+
+        if (!file) {
+            throw std::runtime_error("unable to open " + filename_);
+        }
+
+        write(file, &header, sizeof(header), 0);
+
+        std::vector<T> bounds(2 * dims);
+
+        if (points) {
+            std::copy(kdtree.bounds().min().begin(), kdtree.bounds().min().end(), bounds.begin());
+            std::copy(kdtree.bounds().max().begin(), kdtree.bounds().max().end(), bounds.begin() + dims);
+        }
+
+        write(file, bounds.data(), bounds.size() * sizeof(T), header.boundsOffset_);
+
+        // nodes are copied field by field so padding bytes are written as zeros and the file is reproducible
+        std::vector<KDNode> nodes(nodeCount);
+        if (!nodes.empty()) std::memset(static_cast<void*>(nodes.data()), 0, nodes.size() * sizeof(KDNode));
+
+        for (std::size_t i = 0; i < nodeCount; i++) {
+
+            nodes[i].split_ = kdtree.nodes_[i].split_;
+            nodes[i].dim_ = kdtree.nodes_[i].dim_;
+            nodes[i].left_ = kdtree.nodes_[i].left_;
+            nodes[i].right_ = kdtree.nodes_[i].right_;
+            nodes[i].first_ = kdtree.nodes_[i].first_;
+            nodes[i].count_ = kdtree.nodes_[i].count_;
+        }
+
+        write(file, nodes.data(), nodes.size() * sizeof(KDNode), header.nodesOffset_);
+        write(file, kdtree.coordinates_.begin(), kdtree.coordinates_.size() * sizeof(T), header.coordinatesOffset_);
+        write(file, kdtree.ids_.begin(), kdtree.ids_.size() * sizeof(std::uint64_t), header.idsOffset_);
+
+        if (!file) {
+            throw std::runtime_error("unable to write " + filename_);
+        }
+    }
+
+    private:
+
+    /*
+     * helper function to write a section, zero padding the file up to its offset first
+     */
+    static void write(std::ofstream& file, const void* data, const std::size_t& bytes, const std::uint64_t& offset) {
+
+        static const char padding[BinaryFileHeader::ALIGNMENT] = {};
+
+        std::uint64_t position = file.tellp();
+        file.write(padding, offset - position);
+        file.write(static_cast<const char*>(data), bytes);
+    }
+
+    /*
+     * filename of file to store on disk
+     */
+    std::string filename_;
+
+}; // class BinaryFileWriter
+
+} // namespace rossb83
+
+#endif // ROSSB83_BINARY_FILE_WRITER_HPP
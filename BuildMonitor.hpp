@@ -0,0 +1,194 @@
+#ifndef ROSSB83_BUILD_MONITOR_HPP
+#define ROSSB83_BUILD_MONITOR_HPP
+
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+// ben's namespace
+namespace rossb83 {
+
+/*
+ * times the phases of a build and reports progress of the long ones, so where the time of a
+ * long build goes can be seen from its log without attaching a profiler
+ *
+ * a phase is timed from begin() to end(), each finished phase is logged with its duration and
+ * throughput, in between advance() counts the items done and logs the progress of the phase at
+ * most once per interval, phases run one at a time but advance() may be called from any thread
+ */
+class BuildMonitor {
+
+    public:
+
+    /*
+     * helper nested struct - a finished phase
+     */
+    struct Phase {
+
+        /*
+         * name of the phase
+         */
+        std::string name_;
+
+        /*
+         * wall clock seconds the phase took
+         */
+        double seconds_;
+
+        /*
+         * number of items the phase processed, 0 if it has no natural unit of work
+         */
+        std::size_t items_;
+
+    }; // struct Phase
+
+    /*
+     * ctor
+     * input log - stream every phase and progress line is written to
+     * input interval - least seconds between two progress lines of a phase
+     */
+    BuildMonitor(std::ostream& log, const double& interval = 1.0) : log_(log), interval_(interval), total_(0), done_(0) {}
+
+    // don't allow copying a monitor, its progress is shared by every thread of a build
+    BuildMonitor(BuildMonitor& other) = delete;
+
+    /*
+     * starts timing a phase
+     * input name - name of the phase
+     * input items - number of items the phase will process, 0 if unknown
+     */
+    void begin(const std::string& name, const std::size_t& items = 0) {
+
+        name_ = name;
+        total_ = items;
+        done_.store(0, std::memory_order_relaxed);
+        start_ = last_ = std::chrono::steady_clock::now();
+    }
+
+    /*
+     * counts items done by the current phase and logs its progress once interval has passed
+     * since the last progress line, safe to call from any thread
+     */
+    void advance(const std::size_t& items) {
+
+        std::size_t done = done_.fetch_add(items, std::memory_order_relaxed) + items;
+
+        // a thread that finds the log busy skips the line instead of waiting
+        std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+
+        if (!lock.owns_lock()) return;
+
+        auto now = std::chrono::steady_clock::now();
+
+        if (std::chrono::duration<double>(now - last_).count() < interval_) return;
+
+        last_ = now;
+        log_ << "\t" << name_ << ": " << done;
+
+        if (total_ > 0) log_ << " of " << total_ << " (" << 100 * done / total_ << "%)";
+
+        log_ << " after " << std::chrono::duration<double>(now - start_).count() << "s" << std::endl;
+    }
+
+    /*
+     * stops timing the current phase, records and logs it
+     * input items - number of items the phase processed, 0 keeps the count given to begin()
+     */
+    void end(const std::size_t& items = 0) {
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+
+        phases_.push_back({name_, seconds, items ? items : total_});
+
+        log_ << "phase " << name_ << ": " << seconds << "s";
+
+        if (phases_.back().items_ > 0 && seconds > 0) log_ << ", " << phases_.back().items_ / seconds << " per second";
+
+        log_ << std::endl;
+    }
+
+    /*
+     * getter - every finished phase in the order they ran
+     */
+    const std::vector<Phase>& phases() const {return phases_;}
+
+    /*
+     * getter - seconds taken by every finished phase together
+     */
+    double seconds() const {
+
+        double total = 0.0;
+        for (const Phase& phase : phases_) total += phase.seconds_;
+
+        return total;
+    }
+
+    /*
+     * writes every finished phase to a json file
+     * input filename - file to create
+     * input points - number of points built, to report the overall throughput
+     */
+    void writeFile(const std::string& filename, const std::size_t& points) const {
+
+        std::ofstream out(filename);
+
+        // possible user error here, file can not be created
+        if (!out) {
+
+            throw std::runtime_error("unable to open " + filename);
+        }
+
+        out << "{\n  \"points\": " << points << ",\n  \"seconds\": " << seconds()
+            << ",\n  \"points_per_second\": " << ((seconds() > 0) ? points / seconds() : 0.0) << ",\n  \"phases\": [\n";
+
+        for (std::size_t i = 0; i < phases_.size(); i++) {
+
+            out << "    {\"phase\": \"" << phases_[i].name_ << "\", \"seconds\": " << phases_[i].seconds_ << ", \"items\": " << phases_[i].items_
+                << ", \"items_per_second\": " << ((phases_[i].seconds_ > 0) ? phases_[i].items_ / phases_[i].seconds_ : 0.0) << "}"
+                << ((i + 1 < phases_.size()) ? ",\n" : "\n");
+        }
+
+        out << "  ]\n}\n";
+    }
+
+    private:
+
+    /*
+     * stream phases and progress are logged to
+     */
+    std::ostream& log_;
+
+    /*
+     * least seconds between two progress lines
+     */
+    double interval_;
+
+    /*
+     * current phase, its expected and finished items and when it started and last logged progress
+     */
+    std::string name_;
+    std::size_t total_;
+    std::atomic<std::size_t> done_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point last_;
+
+    /*
+     * serializes progress lines
+     */
+    std::mutex mutex_;
+
+    /*
+     * every finished phase
+     */
+    std::vector<Phase> phases_;
+
+}; // class BuildMonitor
+
+} // namespace rossb83
+
+#endif // ROSSB83_BUILD_MONITOR_HPP
@@ -0,0 +1,94 @@
+#ifndef ROSSB83_BUILD_MONITOR_TEST_HPP
+#define ROSSB83_BUILD_MONITOR_TEST_HPP
+
+#include <assert.h>
+#include <sstream>
+#include <random>
+
+#include "BuildMonitor.hpp"
+#include "kdtree.hpp"
+
+namespace rossb83 {
+
+ class BuildMonitorTest {
+
+  public:
+
+   BuildMonitorTest() {
+
+    std::cout << "Running Build Monitor tests..." << std::endl;
+
+    phaseTest();
+    buildTest();
+   }
+
+  private:
+
+   void phaseTest() {
+
+    std::cout << "BuildMonitor phase test..." << std::endl;
+
+    std::ostringstream log;
+    BuildMonitor monitor(log, 0.0);
+
+    monitor.begin("first", 10);
+    monitor.advance(4);
+    monitor.end();
+
+    monitor.begin("second");
+    monitor.end(7);
+
+    assert(monitor.phases().size() == 2);
+    assert(monitor.phases()[0].name_ == "first" && monitor.phases()[0].items_ == 10);
+    assert(monitor.phases()[1].name_ == "second" && monitor.phases()[1].items_ == 7);
+    assert(monitor.seconds() == monitor.phases()[0].seconds_ + monitor.phases()[1].seconds_);
+
+    // progress against the expected items, then one line per finished phase
+    assert(log.str().find("\tfirst: 4 of 10 (40%)") == 0);
+    assert(log.str().find("phase first: ") != std::string::npos);
+    assert(log.str().find("phase second: ") != std::string::npos);
+   }
+
+   void buildTest() {
+
+    std::cout << "BuildMonitor build test..." << std::endl;
+
+    std::mt19937_64 generator(1);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    std::vector<Point<double>> points(20000, Point<double>(3));
+
+    for (Point<double>& p : points) {
+     for (double& value : p) value = uniform(generator);
+    }
+
+    auto splitPointStrategy = std::make_shared<SplitPointSortStrategy<double>>();
+    auto splitAxisStrategy = std::make_shared<SplitAxisRoundRobinStrategy<double>>();
+
+    std::ostringstream log;
+    BuildMonitor monitor(log, 0.0);
+
+    KDTree<double> monitoredKDTree(points.begin(), points.end(), splitPointStrategy, splitAxisStrategy, 1, 1, true, &monitor);
+    KDTree<double> sampleKDTree(points.begin(), points.end(), splitPointStrategy, splitAxisStrategy, 1, 1, true);
+
+    // monitoring does not change the tree
+    assert(monitoredKDTree == sampleKDTree);
+
+    std::vector<std::string> names;
+    for (const BuildMonitor::Phase& phase : monitor.phases()) names.push_back(phase.name_);
+
+    assert((names == std::vector<std::string>{"dedup", "allocate", "split", "compact"}));
+
+    // every point is counted once by the time splitting is done
+    std::string lines = log.str();
+    std::size_t last = lines.rfind("\tsplit: ");
+
+    assert(last != std::string::npos);
+    assert(lines.find("\tsplit: 20000 of 20000 (100%)", last) == last);
+   }
+
+ }; // class BuildMonitorTest
+
+} // namespace rossb83
+
+#endif // ROSSB83_BUILD_MONITOR_TEST_HPP
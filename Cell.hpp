@@ -0,0 +1,110 @@
+#ifndef ROSSB83_CELL_HPP
+#define ROSSB83_CELL_HPP
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "Point.hpp"
+
+namespace rossb83 {
+
+ // cell will hold an axis-aligned box in k-dimensional space given by its min and max corners,
+ // bounds are inclusive on both sides
+ //
+ // example: (0,0)-(2,1) is the cell of points with 0 <= x <= 2 and 0 <= y <= 1
+ //
+ // K is the compile time dimensionality of the corners, 0 when chosen at runtime
+ template<typename T, std::size_t K = 0>
+ class Cell {
+
+  public:
+
+   // creates an empty cell
+   Cell() {}
+
+   // creates an unbounded cell of specified dimensionality
+   Cell(const std::size_t& dims) : min_(dims), max_(dims) {
+
+    std::fill(min_.begin(), min_.end(), std::numeric_limits<T>::lowest());
+    std::fill(max_.begin(), max_.end(), std::numeric_limits<T>::max());
+   }
+
+   // creates a cell spanning min to max
+   Cell(const Point<T,K>& min, const Point<T,K>& max) : min_(min), max_(max) {
+
+    // possible user error here, corners of different dimensionality
+    if (min_.dims() != max_.dims()) {
+
+     throw std::runtime_error("Cell corner dimensionality does not match");
+    }
+   }
+
+   // true iff point lies inside or on the boundary of this cell
+   bool contains(const Point<T,K>& p) const {
+
+    for (std::size_t i = 0; i < dims(); i++) {
+     if (p[i] < min_[i] || max_[i] < p[i]) return false;
+    }
+
+    return true;
+   }
+
+   // true iff every point of other cell lies inside this cell
+   bool contains(const Cell<T,K>& other) const {
+
+    for (std::size_t i = 0; i < dims(); i++) {
+     if (other.min_[i] < min_[i] || max_[i] < other.max_[i]) return false;
+    }
+
+    return true;
+   }
+
+   // true iff this cell and other cell share at least one point
+   bool intersects(const Cell<T,K>& other) const {
+
+    for (std::size_t i = 0; i < dims(); i++) {
+     if (other.max_[i] < min_[i] || max_[i] < other.min_[i]) return false;
+    }
+
+    return true;
+   }
+
+   bool operator!=(const Cell<T,K>& other) const {
+
+    return !(*this == other);
+   }
+
+   bool operator==(const Cell<T,K>& other) const {
+
+    return (min_ == other.min_) && (max_ == other.max_);
+   }
+
+   // getter - min corner
+   const Point<T,K>& min() const {return min_;}
+
+   // setter - min corner, narrowed and restored while descending a tree
+   Point<T,K>& min() {return min_;}
+
+   // getter - max corner
+   const Point<T,K>& max() const {return max_;}
+
+   // setter - max corner, narrowed and restored while descending a tree
+   Point<T,K>& max() {return max_;}
+
+   // getter - dimensionality of cell
+   std::size_t dims() const {return min_.dims();}
+
+  private:
+
+   // corner with the smallest value in every dimension
+   Point<T,K> min_;
+
+   // corner with the largest value in every dimension
+   Point<T,K> max_;
+
+ }; // class Cell
+
+} // namespace rossb83
+
+#endif // ROSSB83_CELL_HPP
@@ -0,0 +1,75 @@
+#ifndef ROSSB83_CELL_TEST_HPP
+#define ROSSB83_CELL_TEST_HPP
+
+#include <assert.h>
+
+#include "Cell.hpp"
+
+namespace rossb83 {
+
+ class CellTest {
+
+  public:
+
+   CellTest() {
+
+    std::cout << "Running Cell tests..." << std::endl;
+
+    createTest();
+    containsPointTest();
+    containsCellTest();
+    intersectsTest();
+   }
+
+  private:
+
+   void createTest() {
+
+    std::cout << "Cell create test..." << std::endl;
+
+    assert(c1.dims() == 2);
+    assert(c1.min() == Point<int>({0,0}));
+    assert(c1.max() == Point<int>({4,4}));
+
+    Cell<int> unbounded(2);
+    assert(unbounded.contains(c1));
+    assert(!c1.contains(unbounded));
+   }
+
+   void containsPointTest() {
+
+    std::cout << "Cell contains point test..." << std::endl;
+
+    assert(c1.contains(Point<int>({2,2})));
+    assert(c1.contains(Point<int>({0,4})));
+    assert(!c1.contains(Point<int>({5,2})));
+    assert(!c1.contains(Point<int>({2,-1})));
+   }
+
+   void containsCellTest() {
+
+    std::cout << "Cell contains cell test..." << std::endl;
+
+    assert(c1.contains(c1));
+    assert(c1.contains(Cell<int>({1,1},{3,4})));
+    assert(!c1.contains(c2));
+   }
+
+   void intersectsTest() {
+
+    std::cout << "Cell intersects test..." << std::endl;
+
+    assert(c1.intersects(c2));
+    assert(c2.intersects(c1));
+    assert(c1.intersects(Cell<int>({4,4},{6,6})));
+    assert(!c1.intersects(Cell<int>({5,0},{6,6})));
+   }
+
+   const Cell<int> c1 = Cell<int>({0,0},{4,4});
+   const Cell<int> c2 = Cell<int>({3,3},{6,6});
+
+ }; // class CellTest
+
+} // namespace rossb83
+
+#endif // ROSSB83_CELL_TEST_HPP
@@ -0,0 +1,292 @@
+#ifndef ROSSB83_DISTANCE_KERNEL_HPP
+#define ROSSB83_DISTANCE_KERNEL_HPP
+
+#include <vector>
+#include <limits>
+#include <type_traits>
+#include <cstddef>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ROSSB83_DISTANCE_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+// ben's namespace
+namespace rossb83 {
+
+/*
+ * squared euclidean distance between two arrays of coordinates, the inner loop of every query
+ *
+ * short arrays are summed inline, longer ones go through the widest simd kernel the cpu supports,
+ * picked once at runtime so one binary runs everywhere: avx-512, avx2 with fma, sse2 and finally
+ * a portable loop, simd kernels exist for float and double coordinates, other types always use
+ * the portable loop
+ *
+ * every kernel takes a bound and may stop as soon as the partial sum exceeds it, returning that
+ * partial sum, so a result above the bound only means "farther than the bound" while a result at
+ * or below it is exact
+ */
+template <typename T>
+class DistanceKernel {
+
+    public:
+
+    typedef double (*Function)(const T* a, const T* b, std::size_t dims, double bound);
+
+    /*
+     * helper nested struct - a kernel and the name of the instruction set it uses
+     */
+    struct Kernel {
+
+        const char* name_;
+        Function function_;
+    };
+
+    /*
+     * arrays shorter than this are summed inline, the call through the kernel pointer would cost more than it saves
+     */
+    static const std::size_t SIMD_DIMS = 8;
+
+    /*
+     * squared distance between a and b
+     * input a, b - dims coordinates each
+     * input dims - number of coordinates
+     * input bound - the kernel may stop once the distance is known to exceed this
+     * output squared distance, or a partial sum above bound
+     */
+    static double squaredDistance(const T* a, const T* b, const std::size_t& dims,
+                                  const double& bound = std::numeric_limits<double>::max()) {
+
+        if (dims < SIMD_DIMS) {
+
+            double sum = 0.0;
+
+            // constant trip count when dims is a compile time constant, so the loop unrolls
+            for (std::size_t i = 0; i < dims; i++) {
+                sum += square(a[i], b[i]);
+            }
+
+            return sum;
+        }
+
+        return selected().function_(a, b, dims, bound);
+    }
+
+    /*
+     * getter - kernel squaredDistance uses for long arrays
+     */
+    static const Kernel& selected() {
+
+        static const Kernel kernel = supported().front();
+        return kernel;
+    }
+
+    /*
+     * getter - every kernel the cpu can run, widest first and the portable loop last
+     */
+    static const std::vector<Kernel>& supported() {
+
+        static const std::vector<Kernel> kernels = detect();
+        return kernels;
+    }
+
+    private:
+
+    /*
+     * helper function to square the difference of two coordinates, widened to double first like the simd lanes
+     */
+    static double square(const T& a, const T& b) {
+
+        double difference = static_cast<double>(a) - static_cast<double>(b);
+        return difference * difference;
+    }
+
+    /*
+     * helper function to list the kernels the cpu can run
+     */
+    static std::vector<Kernel> detect() {
+
+        std::vector<Kernel> kernels;
+
+#ifdef ROSSB83_DISTANCE_KERNEL_X86
+        if constexpr (std::is_same<T, double>::value || std::is_same<T, float>::value) {
+
+            __builtin_cpu_init();
+
+            if (__builtin_cpu_supports("avx512f")) kernels.push_back({"avx512", &avx512});
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) kernels.push_back({"avx2", &avx2});
+            if (__builtin_cpu_supports("sse2")) kernels.push_back({"sse2", &sse2});
+        }
+#endif
+
+        kernels.push_back({"portable", &portable});
+
+        return kernels;
+    }
+
+    /*
+     * portable kernel, checks the bound every few coordinates
+     */
+    static double portable(const T* a, const T* b, std::size_t dims, double bound) {
+
+        double sum = 0.0;
+        std::size_t i = 0;
+
+        for (; i + 8 <= dims; i += 8) {
+
+            for (std::size_t j = i; j < i + 8; j++) {
+                sum += square(a[j], b[j]);
+            }
+
+            if (sum > bound) return sum;
+        }
+
+        for (; i < dims; i++) {
+            sum += square(a[i], b[i]);
+        }
+
+        return sum;
+    }
+
+#ifdef ROSSB83_DISTANCE_KERNEL_X86
+
+    /*
+     * loads of consecutive coordinates widened to double lanes
+     */
+    __attribute__((target("sse2"))) static __m128d load2(const double* p) {return _mm_loadu_pd(p);}
+    __attribute__((target("sse2"))) static __m128d load2(const float* p) {return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));}
+    __attribute__((target("avx2"))) static __m256d load4(const double* p) {return _mm256_loadu_pd(p);}
+    __attribute__((target("avx2"))) static __m256d load4(const float* p) {return _mm256_cvtps_pd(_mm_loadu_ps(p));}
+    __attribute__((target("avx512f"))) static __m512d load8(const double* p) {return _mm512_loadu_pd(p);}
+    __attribute__((target("avx512f"))) static __m512d load8(const float* p) {return _mm512_cvtps_pd(_mm256_loadu_ps(p));}
+
+    /*
+     * horizontal sums of double lanes
+     */
+    __attribute__((target("sse2"))) static double reduce(__m128d v) {return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));}
+    __attribute__((target("avx2"))) static double reduce(__m256d v) {return reduce(_mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)));}
+
+    /*
+     * avx-512 kernel, 16 coordinates per step in two accumulators, bound checked after every step
+     */
+    __attribute__((target("avx512f")))
+    static double avx512(const T* a, const T* b, std::size_t dims, double bound) {
+
+        __m512d sum0 = _mm512_setzero_pd();
+        __m512d sum1 = _mm512_setzero_pd();
+        std::size_t i = 0;
+
+        for (; i + 16 <= dims; i += 16) {
+
+            __m512d d0 = _mm512_sub_pd(load8(a + i), load8(b + i));
+            __m512d d1 = _mm512_sub_pd(load8(a + i + 8), load8(b + i + 8));
+            sum0 = _mm512_fmadd_pd(d0, d0, sum0);
+            sum1 = _mm512_fmadd_pd(d1, d1, sum1);
+
+            double sum = _mm512_reduce_add_pd(_mm512_add_pd(sum0, sum1));
+            if (sum > bound) return sum;
+        }
+
+        for (; i + 8 <= dims; i += 8) {
+
+            __m512d d0 = _mm512_sub_pd(load8(a + i), load8(b + i));
+            sum0 = _mm512_fmadd_pd(d0, d0, sum0);
+        }
+
+        double sum = _mm512_reduce_add_pd(_mm512_add_pd(sum0, sum1));
+
+        for (; i < dims; i++) {
+            sum += square(a[i], b[i]);
+        }
+
+        return sum;
+    }
+
+    /*
+     * avx2 kernel, 8 coordinates per step in two accumulators, bound checked after every other step
+     */
+    __attribute__((target("avx2,fma")))
+    static double avx2(const T* a, const T* b, std::size_t dims, double bound) {
+
+        __m256d sum0 = _mm256_setzero_pd();
+        __m256d sum1 = _mm256_setzero_pd();
+        std::size_t i = 0;
+
+        for (; i + 16 <= dims; i += 16) {
+
+            for (std::size_t j = i; j < i + 16; j += 8) {
+
+                __m256d d0 = _mm256_sub_pd(load4(a + j), load4(b + j));
+                __m256d d1 = _mm256_sub_pd(load4(a + j + 4), load4(b + j + 4));
+                sum0 = _mm256_fmadd_pd(d0, d0, sum0);
+                sum1 = _mm256_fmadd_pd(d1, d1, sum1);
+            }
+
+            double sum = reduce(_mm256_add_pd(sum0, sum1));
+            if (sum > bound) return sum;
+        }
+
+        for (; i + 4 <= dims; i += 4) {
+
+            __m256d d0 = _mm256_sub_pd(load4(a + i), load4(b + i));
+            sum0 = _mm256_fmadd_pd(d0, d0, sum0);
+        }
+
+        double sum = reduce(_mm256_add_pd(sum0, sum1));
+
+        for (; i < dims; i++) {
+            sum += square(a[i], b[i]);
+        }
+
+        return sum;
+    }
+
+    /*
+     * sse2 kernel, 4 coordinates per step in two accumulators, bound checked after every fourth step
+     */
+    __attribute__((target("sse2")))
+    static double sse2(const T* a, const T* b, std::size_t dims, double bound) {
+
+        __m128d sum0 = _mm_setzero_pd();
+        __m128d sum1 = _mm_setzero_pd();
+        std::size_t i = 0;
+
+        for (; i + 16 <= dims; i += 16) {
+
+            for (std::size_t j = i; j < i + 16; j += 4) {
+
+                __m128d d0 = _mm_sub_pd(load2(a + j), load2(b + j));
+                __m128d d1 = _mm_sub_pd(load2(a + j + 2), load2(b + j + 2));
+                sum0 = _mm_add_pd(sum0, _mm_mul_pd(d0, d0));
+                sum1 = _mm_add_pd(sum1, _mm_mul_pd(d1, d1));
+            }
+
+            double sum = reduce(_mm_add_pd(sum0, sum1));
+            if (sum > bound) return sum;
+        }
+
+        for (; i + 2 <= dims; i += 2) {
+
+            __m128d d0 = _mm_sub_pd(load2(a + i), load2(b + i));
+            sum0 = _mm_add_pd(sum0, _mm_mul_pd(d0, d0));
+        }
+
+        double sum = reduce(_mm_add_pd(sum0, sum1));
+
+        for (; i < dims; i++) {
+            sum += square(a[i], b[i]);
+        }
+
+        return sum;
+    }
+
+#endif // ROSSB83_DISTANCE_KERNEL_X86
+
+}; // class DistanceKernel
+
+template <typename T>
+const std::size_t DistanceKernel<T>::SIMD_DIMS;
+
+} // namespace rossb83
+
+#endif // ROSSB83_DISTANCE_KERNEL_HPP
@@ -0,0 +1,110 @@
+#ifndef ROSSB83_DISTANCE_KERNEL_TEST_HPP
+#define ROSSB83_DISTANCE_KERNEL_TEST_HPP
+
+#include <assert.h>
+#include <random>
+
+#include "DistanceKernel.hpp"
+
+namespace rossb83 {
+
+ class DistanceKernelTest {
+
+  public:
+
+   DistanceKernelTest() {
+
+    std::cout << "Running DistanceKernel tests..." << std::endl;
+
+    kernelTest<double>();
+    kernelTest<float>();
+    boundTest();
+    integerTest();
+   }
+
+  private:
+
+   // every kernel the cpu supports agrees with a plain loop for every length and alignment
+   template <typename T>
+   void kernelTest() {
+
+    std::cout << "DistanceKernel " << typeid(T).name() << " kernel test..." << std::endl;
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> uniform(-10.0, 10.0);
+
+    std::vector<T> a(140);
+    std::vector<T> b(140);
+
+    for (std::size_t i = 0; i < a.size(); i++) {
+     a[i] = uniform(generator);
+     b[i] = uniform(generator);
+    }
+
+    assert(DistanceKernel<T>::supported().back().name_ == std::string("portable"));
+
+    for (const auto& kernel : DistanceKernel<T>::supported()) {
+
+     for (std::size_t offset = 0; offset < 3; offset++) {
+
+      for (std::size_t dims = 0; dims + offset <= 137; dims++) {
+
+       double expected = 0.0;
+
+       for (std::size_t i = 0; i < dims; i++) {
+        expected += std::norm(double(a[offset + i]) - double(b[offset + i]));
+       }
+
+       double actual = kernel.function_(a.data() + offset, b.data() + offset, dims, std::numeric_limits<double>::max());
+       assert(std::abs(actual - expected) <= 1e-9 * (1.0 + expected));
+      }
+     }
+    }
+
+    // short arrays are summed in order, exactly like a plain loop
+    double expected = 0.0;
+
+    for (std::size_t i = 0; i < 3; i++) {
+     expected += std::norm(double(a[i]) - double(b[i]));
+    }
+
+    assert(DistanceKernel<T>::squaredDistance(a.data(), b.data(), 3) == expected);
+   }
+
+   // a result at or below the bound is exact, one above it only has to exceed the bound
+   void boundTest() {
+
+    std::cout << "DistanceKernel bound test..." << std::endl;
+
+    std::vector<double> a(128, 0.0);
+    std::vector<double> b(128, 1.0);
+
+    for (const auto& kernel : DistanceKernel<double>::supported()) {
+
+     assert(kernel.function_(a.data(), b.data(), 128, 128.0) == 128.0);
+     assert(kernel.function_(a.data(), b.data(), 128, 1000.0) == 128.0);
+
+     double partial = kernel.function_(a.data(), b.data(), 128, 10.0);
+     assert(partial > 10.0 && partial <= 128.0);
+    }
+   }
+
+   // types without a simd kernel still go through the portable loop
+   void integerTest() {
+
+    std::cout << "DistanceKernel integer test..." << std::endl;
+
+    assert(DistanceKernel<int>::supported().size() == 1);
+
+    std::vector<int> a(20, 1);
+    std::vector<int> b(20, 4);
+
+    assert(DistanceKernel<int>::squaredDistance(a.data(), b.data(), 20) == 180.0);
+    assert(DistanceKernel<int>::squaredDistance(a.data(), b.data(), 5) == 45.0);
+   }
+
+ }; // class DistanceKernelTest
+
+} // namespace rossb83
+
+#endif // ROSSB83_DISTANCE_KERNEL_TEST_HPP
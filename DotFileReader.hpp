@@ -172,7 +172,7 @@ class DotFileReader {
                
                 // very ugly code to extract point and dimension for line of text in DOT file
                 
-                std::string label = line.substr(line.find("*") + 1,pointstart - line.find("*") - 11);
+                std::string id = line.substr(line.find("*") + 1,pointstart - line.find("*") - 11);
                 std::istringstream point(line.substr(pointstart + 2, line.find("@") - pointstart - 3));
                 std::istringstream dim(line.substr(line.find("@") + 1, line.length() - line.find("@") - 4));
               
@@ -181,7 +181,7 @@ class DotFileReader {
                 std::size_t d;
                
                 point >> p; // deserialize point
-                p.label(std::move(label)); // add label to point
+                if (!id.empty()) p.id(std::stoull(id)); // add id to point
 
                 dim >> d; // deserialize dimension
  
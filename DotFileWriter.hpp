@@ -23,6 +23,7 @@
 #include <math.h>
 #include <complex>
 #include <cmath>
+#include <stdexcept>
 
 #include "kdtree.hpp"
 
@@ -50,9 +51,15 @@ class DotFileWriter {
     }
 
     /*
-     * iterates through a kdtree in level-order storing its contents in dot file format
+     * iterates through a kdtree in level-order storing its contents in dot file format, a dot file
+     * holds one point per node so trees with leaf buckets must be written as binary files
      */
-    void writeFile(const KDTree<T>& kdtree) const {
+    template <std::size_t K>
+    void writeFile(const KDTree<T,K>& kdtree) const {
+
+        if (kdtree.bucketSize() > 1) {
+            throw std::runtime_error("dot files cannot hold a kdtree with leaf buckets of " + std::to_string(kdtree.bucketSize()) + " points");
+        }
 
         std::ofstream file(filename_);
         int nodelabel = 0;
@@ -65,7 +72,7 @@ class DotFileWriter {
             if (p.first != Point<T>()) { // write node to dot file
                
                 // text to represent node
-                file << "\t" << nodelabel++ << " /*" << p.first.label() << "*/";
+                file << "\t" << nodelabel++ << " /*" << p.first.id() << "*/";
                 file << " [label=\"" << p.first << "@" << p.second << "\"];" << std::endl;
             } else { // write null to dot file
 
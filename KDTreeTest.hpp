@@ -4,7 +4,11 @@
 #include "kdtree.hpp"
 #include "DotFileWriter.hpp"
 #include "DotFileReader.hpp"
+#include "BinaryFileWriter.hpp"
+#include "BinaryFileReader.hpp"
 #include "SplitAxisRangeStrategy.hpp"
+#include "SplitAxisStrategyFactory.hpp"
+#include "SplitPointStrategyFactory.hpp"
 
 namespace rossb83 {
 
@@ -16,9 +20,23 @@ namespace rossb83 {
   
        createTest();
        ReadWriteIntegrationTest();
+       binaryReadWriteIntegrationTest();
        equalityTest();
        inequalityTest();
        queryNearestNeighborTest();
+       queryDimensionalityTest();
+       queryKNearestTest();
+       queryRadiusTest();
+       queryBoxTest();
+       batchQueryTest();
+       queryContextTest();
+       approximateQueryTest();
+       bestBinFirstTest();
+       bucketTest();
+       presortTest();
+       pointRangeTest();
+       parallelBuildTest();
+       fixedDimensionTest();
        nearestNeighborIntegrationTest();
    }
 
@@ -38,6 +56,105 @@ namespace rossb83 {
        assert(kdtree == kdtree_integ);
    }
 
+   void binaryReadWriteIntegrationTest() {
+
+       std::cout << "kdtree binary read/write integration test..." << std::endl;
+
+       PCDFile<double> pcd("sample_data.csv");
+       KDTree<double> sampleKDTree(pcd);
+
+       BinaryFileWriter<double> binaryfilewriter("tree.kdt");
+       binaryfilewriter.writeFile(sampleKDTree);
+
+       assert(BinaryFileReader<double>::isBinaryFile("tree.kdt"));
+       assert(!BinaryFileReader<double>::isBinaryFile("sample_kdtree.dot"));
+
+       {
+           // binary files are lossless, coordinates and ids read back exactly
+           BinaryFileReader<double> binaryfilereader("tree.kdt");
+           KDTree<double> mappedKDTree(binaryfilereader);
+
+           assert(mappedKDTree == sampleKDTree);
+           assert(mappedKDTree.bounds() == sampleKDTree.bounds());
+
+           for (std::size_t i = 0; i < sampleKDTree.points(); i++) {
+               assert(mappedKDTree.id(i) == sampleKDTree.id(i));
+               assert(mappedKDTree.point(i).id() == sampleKDTree.id(i));
+           }
+
+           // queries run straight out of the mapped file, also after moving the tree
+           KDTree<double> movedKDTree(std::move(mappedKDTree));
+           Point<double> queryPoint({0.1, -0.2, 0.3});
+
+           assert(std::get<0>(movedKDTree.queryNearestNeighbor(queryPoint)) == std::get<0>(sampleKDTree.queryNearestNeighbor(queryPoint)));
+           assert(std::get<1>(movedKDTree.queryKNearest(queryPoint, 5)) == std::get<1>(sampleKDTree.queryKNearest(queryPoint, 5)));
+       }
+
+       // wrong coordinate type and wrong dimensionality are refused
+       bool thrown = false;
+
+       try {
+           BinaryFileReader<float> binaryfilereader("tree.kdt");
+       } catch (const std::runtime_error& e) {
+           thrown = true;
+       }
+
+       assert(thrown);
+       thrown = false;
+
+       try {
+           BinaryFileReader<double> binaryfilereader("tree.kdt");
+           KDTree<double,2> fixedKDTree(binaryfilereader);
+       } catch (const std::runtime_error& e) {
+           thrown = true;
+       }
+
+       assert(thrown);
+
+       // corrupt nodes are refused when the file is opened rather than read out of bounds by a query
+       auto corrupt = [](const std::size_t& offset, const std::uint32_t& value) {
+
+           std::uint64_t nodesOffset = BinaryFileReader<double>("tree.kdt").header().nodesOffset_;
+
+           std::fstream file("tree.kdt", std::ios::in | std::ios::out | std::ios::binary);
+           file.seekp(nodesOffset + offset);
+           file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+       };
+
+       // dim_ of the root follows its split, then its left child, right child, first point and point count,
+       // a root owning the first point would have a left subtree ending at point -1
+       for (const auto& field : std::vector<std::pair<std::size_t, std::uint32_t>>{{sizeof(double), 3}, {sizeof(double) + 4, 1u << 30},
+                                                                                   {sizeof(double) + 12, 0}, {sizeof(double) + 16, 2}}) {
+
+           binaryfilewriter.writeFile(sampleKDTree);
+           corrupt(field.first, field.second);
+           thrown = false;
+
+           try {
+               BinaryFileReader<double> binaryfilereader("tree.kdt");
+               KDTree<double> corruptKDTree(binaryfilereader);
+           } catch (const std::runtime_error& e) {
+               thrown = true;
+           }
+
+           assert(thrown);
+       }
+
+       // empty trees round trip too
+       KDTree<double> emptyKDTree(PointCloud<double>(0, 3),
+           std::make_shared<SplitPointSortStrategy<double>>(), std::make_shared<SplitAxisRoundRobinStrategy<double>>());
+
+       binaryfilewriter.writeFile(emptyKDTree);
+
+       BinaryFileReader<double> binaryfilereader("tree.kdt");
+       KDTree<double> mappedEmptyKDTree(binaryfilereader);
+
+       assert(mappedEmptyKDTree.points() == 0);
+       assert(mappedEmptyKDTree == emptyKDTree);
+
+       std::remove("tree.kdt");
+   }
+
    void equalityTest() {
 
        std::cout << "kdtree equality test..." << std::endl;
@@ -83,40 +200,789 @@ namespace rossb83 {
         for (Point<double> queryPoint : queryPointCloud) {
 
             std::tuple<Point<double>, double, int> t1 = samplePointCloud.queryNearestNeighbor(queryPoint);
-            std::tuple<Point<double>, double, int> t2 = sampleKDTreeRead.queryNearestNeighbor(queryPoint);
+            std::tuple<std::size_t, double, int> t2 = sampleKDTreeRead.queryNearestNeighbor(queryPoint);
 
-            for (int i = 0; i < queryPoint.dims(); i++) {
-            
-                assert(std::abs(std::get<0>(t1)[i] - std::get<0>(t2)[i]));
-            }
-           
-            assert(std::get<0>(t1).label() == std::get<0>(t2).label());
+            assert(std::get<0>(t1).id() == std::get<0>(t2));
             assert(std::abs(std::get<1>(t1) - std::get<1>(t2)) < epsilon);
             assert(std::get<2>(t1) > std::get<2>(t2));
         }
     }
 
+    void queryKNearestTest() {
+
+        std::cout << "kdtree query k nearest test..." << std::endl;
+
+        std::tuple<std::vector<std::size_t>,std::vector<double>,int> nearest = kdtree.queryKNearest({5.1,6},2);
+        assert(std::get<0>(nearest).size() == 2);
+        assert(std::get<0>(nearest)[0] == 2);
+        assert(std::get<0>(nearest)[1] == 1);
+        assert(std::abs(std::get<1>(nearest)[0] - 0.1) < epsilon);
+
+        // asking for more neighbors than points returns every point
+        nearest = kdtree.queryKNearest({0,0},5);
+        assert(std::get<0>(nearest).size() == 3);
+        assert(std::get<0>(nearest)[0] == 0);
+        assert(std::get<0>(nearest)[2] == 2);
+
+        nearest = kdtree.queryKNearest({0,0},0);
+        assert(std::get<0>(nearest).empty());
+
+        // compare against brute force distances on the sample data
+        PCDFile<double> pcd("sample_data.csv");
+        KDTree<double> sampleKDTree(pcd);
+        std::vector<Point<double>> samplePoints;
+
+        for (Point<double> p : pcd) {
+            samplePoints.push_back(p);
+        }
+
+        for (Point<double> queryPoint : {Point<double>({0.5,0.5,0.5}), Point<double>({0.1,0.9,0.3})}) {
+
+            std::vector<double> distances;
+
+            for (const Point<double>& p : samplePoints) {
+                distances.push_back(std::sqrt(std::norm(queryPoint - p)));
+            }
+
+            std::sort(distances.begin(), distances.end());
+
+            nearest = sampleKDTree.queryKNearest(queryPoint,10);
+            assert(std::get<1>(nearest).size() == 10);
+
+            for (std::size_t i = 0; i < 10; i++) {
+                assert(std::abs(std::get<1>(nearest)[i] - distances[i]) < epsilon);
+            }
+
+            assert(std::get<2>(nearest) < samplePoints.size());
+        }
+    }
+
+    void queryRadiusTest() {
+
+        std::cout << "kdtree query radius test..." << std::endl;
+
+        std::tuple<std::vector<std::size_t>,std::vector<double>,int> neighbors = kdtree.queryRadius({3,4},3);
+        assert(std::get<0>(neighbors).size() == 3);
+        assert(std::get<0>(neighbors)[0] == 1);
+        assert(std::get<1>(neighbors)[0] == 0);
+
+        neighbors = kdtree.queryRadius({5.1,6},1);
+        assert(std::get<0>(neighbors).size() == 1);
+        assert(std::get<0>(neighbors)[0] == 2);
+
+        neighbors = kdtree.queryRadius({10,10},1);
+        assert(std::get<0>(neighbors).empty());
+
+        // compare against brute force counts on the sample data
+        PCDFile<double> pcd("sample_data.csv");
+        KDTree<double> sampleKDTree(pcd);
+        std::vector<Point<double>> samplePoints;
+
+        for (Point<double> p : pcd) {
+            samplePoints.push_back(p);
+        }
+
+        std::vector<std::size_t> buffer;
+
+        for (Point<double> queryPoint : {Point<double>({0.5,0.5,0.5}), Point<double>({0.1,0.9,0.3})}) {
+
+            std::size_t count = 0;
+
+            for (const Point<double>& p : samplePoints) {
+                if (std::sqrt(std::norm(queryPoint - p)) <= 0.2) count++;
+            }
+
+            neighbors = sampleKDTree.queryRadius(queryPoint,0.2);
+            assert(std::get<0>(neighbors).size() == count);
+            assert(std::is_sorted(std::get<1>(neighbors).begin(), std::get<1>(neighbors).end()));
+
+            sampleKDTree.queryRadius(queryPoint,0.2,buffer);
+            assert(buffer.size() == count);
+
+            // ids of pcd points are their rows
+            for (std::size_t index : buffer) {
+                assert(std::sqrt(std::norm(queryPoint - sampleKDTree.point(index))) <= 0.2);
+                assert(sampleKDTree.point(index) == samplePoints[sampleKDTree.id(index)]);
+            }
+
+            for (std::size_t id : std::get<0>(neighbors)) {
+                assert(std::sqrt(std::norm(queryPoint - samplePoints[id])) <= 0.2);
+            }
+        }
+    }
+
+    void queryBoxTest() {
+
+        std::cout << "kdtree query box test..." << std::endl;
+
+        std::tuple<std::vector<std::size_t>,int> inside = kdtree.queryBox({0,0},{4,4});
+        assert(std::get<0>(inside).size() == 2);
+
+        inside = kdtree.queryBox({0,0},{10,10});
+        assert(std::get<0>(inside).size() == 3);
+        assert(std::get<1>(inside) == 0);
+
+        inside = kdtree.queryBox({5,6},{5,6});
+        assert(std::get<0>(inside).size() == 1);
+        assert(std::get<0>(inside)[0] == 2);
+
+        inside = kdtree.queryBox({6,0},{10,10});
+        assert(std::get<0>(inside).empty());
+
+        // compare against brute force on the sample data, both built and read from a dot file
+        PCDFile<double> pcd("sample_data.csv");
+        KDTree<double> sampleKDTree(pcd);
+
+        DotFileWriter<double> dotfilewriter("tree.dot");
+        dotfilewriter.writeFile(sampleKDTree);
+
+        DotFileReader<double> dotfilereader("tree.dot");
+        KDTree<double> sampleKDTreeRead(dotfilereader);
+
+        Cell<double> box({0.2,0.3,0.1},{0.6,0.9,0.5});
+        std::vector<std::size_t> indices;
+
+        for (const KDTree<double>* tree : {&sampleKDTree, &sampleKDTreeRead}) {
+
+            std::size_t count = 0;
+
+            for (std::size_t i = 0; i < tree->points(); i++) {
+                if (box.contains(tree->point(i))) count++;
+            }
+
+            std::size_t numnodesvisited = tree->queryBox(box.min(), box.max(), indices);
+            assert(indices.size() == count);
+            assert(numnodesvisited < tree->points());
+
+            for (std::size_t index : indices) {
+                assert(box.contains(tree->point(index)));
+            }
+        }
+    }
+
+    void batchQueryTest() {
+
+        std::cout << "kdtree batch query test..." << std::endl;
+
+        PCDFile<double> pcd1("sample_data.csv");
+        PCDFile<double> pcd2("query_data.csv");
+
+        KDTree<double> sampleKDTree(pcd1);
+        std::vector<Point<double>> queryPoints;
+
+        for (Point<double> p : pcd2) {
+            queryPoints.push_back(p);
+        }
+
+        std::vector<std::tuple<std::size_t, double, std::size_t>> nearest = sampleKDTree.queryNearestNeighbor(queryPoints, 4);
+        std::vector<std::tuple<std::vector<std::size_t>, std::vector<double>, std::size_t>> knearest = sampleKDTree.queryKNearest(queryPoints, 3, 4);
+
+        assert(nearest.size() == queryPoints.size());
+        assert(knearest.size() == queryPoints.size());
+
+        // results come back in input order and match the single query versions
+        for (std::size_t i = 0; i < queryPoints.size(); i++) {
+
+            std::tuple<std::size_t, double, std::size_t> t = sampleKDTree.queryNearestNeighbor(queryPoints[i]);
+
+            assert(std::get<0>(nearest[i]) == std::get<0>(t));
+            assert(std::get<1>(nearest[i]) == std::get<1>(t));
+            assert(std::get<2>(nearest[i]) == std::get<2>(t));
+            assert(std::get<0>(knearest[i])[0] == std::get<0>(t));
+            assert(std::get<1>(knearest[i]).size() == 3);
+        }
+
+        assert(sampleKDTree.queryNearestNeighbor(std::vector<Point<double>>(), 2).empty());
+    }
+
+    void queryContextTest() {
+
+        std::cout << "kdtree query context test..." << std::endl;
+
+        PCDFile<double> pcd1("sample_data.csv");
+        PCDFile<double> pcd2("query_data.csv");
+
+        auto splitPointStrategy = std::make_shared<SplitPointSortStrategy<double>>();
+        auto splitAxisStrategy = std::make_shared<SplitAxisRoundRobinStrategy<double>>();
+
+        KDTree<double> sampleKDTree(pcd1);
+        KDTree<double> bucketKDTree(pcd1, splitPointStrategy, splitAxisStrategy, 1, 8);
+
+        // median splits keep the tree balanced
+        assert(sampleKDTree.height() == 10);
+        assert(bucketKDTree.height() < sampleKDTree.height());
+        assert(kdtree.height() == 2);
+
+        // one context serves every query, also on a taller tree than it was created for
+        KDTree<double>::QueryContext context(bucketKDTree);
+
+        for (const KDTree<double>* tree : {&bucketKDTree, &sampleKDTree}) {
+
+            for (Point<double> queryPoint : pcd2) {
+
+                std::tuple<std::size_t, double, std::size_t> t = tree->queryNearestNeighbor(queryPoint);
+                std::pair<std::size_t, double> nearest = tree->queryNearestNeighbor(queryPoint, context);
+
+                assert(tree->id(nearest.first) == std::get<0>(t));
+                assert(std::sqrt(nearest.second) == std::get<1>(t));
+                assert(std::sqrt(std::norm(queryPoint - tree->point(nearest.first))) == std::get<1>(t));
+
+                nearest = tree->queryNearestNeighbor(queryPoint, context, 0.5);
+                assert(std::sqrt(nearest.second) == std::get<1>(tree->queryNearestNeighbor(queryPoint, 0.5)));
+            }
+        }
+
+        // height survives binary files and empty trees find nothing
+        BinaryFileWriter<double>("tree.kdt").writeFile(sampleKDTree);
+        BinaryFileReader<double> binaryfilereader("tree.kdt");
+        KDTree<double> mappedKDTree(binaryfilereader);
+
+        assert(mappedKDTree.height() == sampleKDTree.height());
+        std::remove("tree.kdt");
+
+        KDTree<double> emptyKDTree(PointCloud<double>(0, 3), splitPointStrategy, splitAxisStrategy);
+        KDTree<double>::QueryContext emptyContext(emptyKDTree);
+
+        assert(emptyKDTree.height() == 0);
+        assert(emptyKDTree.queryNearestNeighbor({0.1, -0.2, 0.3}, emptyContext).first >= emptyKDTree.points());
+    }
+
+    void approximateQueryTest() {
+
+        std::cout << "kdtree approximate query test..." << std::endl;
+
+        PCDFile<double> pcd1("sample_data.csv");
+        PCDFile<double> pcd2("query_data.csv");
+
+        KDTree<double> sampleKDTree(pcd1);
+
+        for (double epsilon : {0.05, 0.5, 2.0}) {
+
+            std::size_t visited = 0;
+            std::size_t approximateVisited = 0;
+
+            for (Point<double> queryPoint : pcd2) {
+
+                std::tuple<std::size_t, double, std::size_t> t = sampleKDTree.queryNearestNeighbor(queryPoint);
+                std::tuple<std::size_t, double, std::size_t> a = sampleKDTree.queryNearestNeighbor(queryPoint, epsilon);
+
+                // never worse than (1+epsilon) times the true distance and never more work
+                assert(std::get<1>(t) <= std::get<1>(a));
+                assert(std::get<1>(a) <= (1.0 + epsilon) * std::get<1>(t) + 1e-12);
+                assert(std::get<2>(a) <= std::get<2>(t));
+
+                visited += std::get<2>(t);
+                approximateVisited += std::get<2>(a);
+
+                std::tuple<std::vector<std::size_t>, std::vector<double>, std::size_t> kt = sampleKDTree.queryKNearest(queryPoint, 5);
+                std::tuple<std::vector<std::size_t>, std::vector<double>, std::size_t> ka = sampleKDTree.queryKNearest(queryPoint, 5, epsilon);
+
+                assert(std::get<1>(ka).size() == 5);
+
+                for (std::size_t i = 0; i < 5; i++) {
+                    assert(std::get<1>(ka)[i] <= (1.0 + epsilon) * std::get<1>(kt)[i] + 1e-12);
+                }
+
+                assert(std::get<2>(ka) <= std::get<2>(kt));
+            }
+
+            assert(approximateVisited < visited);
+        }
+
+        // epsilon of 0 is the exact search and batch queries take epsilon too
+        std::vector<Point<double>> queryPoints(pcd2.begin(), pcd2.end());
+        std::vector<std::tuple<std::size_t, double, std::size_t>> nearest = sampleKDTree.queryNearestNeighbor(queryPoints, 2, 0.5);
+
+        for (std::size_t i = 0; i < queryPoints.size(); i++) {
+
+            assert(std::get<1>(nearest[i]) == std::get<1>(sampleKDTree.queryNearestNeighbor(queryPoints[i], 0.5)));
+            assert(std::get<1>(sampleKDTree.queryNearestNeighbor(queryPoints[i], 0.0)) == std::get<1>(sampleKDTree.queryNearestNeighbor(queryPoints[i])));
+        }
+
+        bool thrown = false;
+
+        try {
+            sampleKDTree.queryNearestNeighbor(queryPoints[0], -0.1);
+        } catch (const std::runtime_error& e) {
+            thrown = true;
+        }
+
+        assert(thrown);
+    }
+
+    void bestBinFirstTest() {
+
+        std::cout << "kdtree best bin first test..." << std::endl;
+
+        PCDFile<double> pcd1("sample_data.csv");
+        PCDFile<double> pcd2("query_data.csv");
+
+        auto splitPointStrategy = std::make_shared<SplitPointSortStrategy<double>>();
+        auto splitAxisStrategy = std::make_shared<SplitAxisRoundRobinStrategy<double>>();
+
+        for (std::size_t bucketSize : {1, 8}) {
+
+            KDTree<double> sampleKDTree(pcd1, splitPointStrategy, splitAxisStrategy, 1, bucketSize);
+            std::size_t exactCount = 0;
+
+            for (Point<double> queryPoint : pcd2) {
+
+                std::tuple<std::size_t, double, std::size_t> t = sampleKDTree.queryNearestNeighbor(queryPoint);
+
+                // an unlimited budget always finishes with the true nearest neighbor
+                std::tuple<std::size_t, double, std::size_t, bool> b = sampleKDTree.queryBestBinFirst(queryPoint, sampleKDTree.points());
+
+                assert(std::get<3>(b));
+                assert(std::get<1>(b) == std::get<1>(t));
+                assert(std::get<0>(b) == std::get<0>(t));
+
+                // a small budget caps the work, a result flagged exact is still the true one
+                b = sampleKDTree.queryBestBinFirst(queryPoint, 16);
+
+                assert(std::get<2>(b) <= 16);
+                assert(std::get<1>(b) >= std::get<1>(t));
+
+                if (std::get<3>(b)) {
+
+                    assert(std::get<1>(b) == std::get<1>(t));
+                    exactCount++;
+                }
+            }
+
+            assert(exactCount > 0);
+
+            // no budget at all finds nothing
+            std::tuple<std::size_t, double, std::size_t, bool> b = sampleKDTree.queryBestBinFirst({0.1, -0.2, 0.3}, 0);
+            assert(!std::get<3>(b) && std::get<2>(b) == 0);
+
+            // batch queries match the single query version
+            std::vector<Point<double>> queryPoints(pcd2.begin(), pcd2.end());
+            std::vector<std::tuple<std::size_t, double, std::size_t, bool>> nearest = sampleKDTree.queryBestBinFirst(queryPoints, 16, 2);
+
+            for (std::size_t i = 0; i < queryPoints.size(); i++) {
+                assert(nearest[i] == sampleKDTree.queryBestBinFirst(queryPoints[i], 16));
+            }
+        }
+
+        // an empty tree is searched exhaustively by definition
+        KDTree<double> emptyKDTree(PointCloud<double>(0, 3),
+            std::make_shared<SplitPointSortStrategy<double>>(), std::make_shared<SplitAxisRoundRobinStrategy<double>>());
+
+        assert(std::get<3>(emptyKDTree.queryBestBinFirst({0.1, -0.2, 0.3}, 4)));
+    }
+
+    void bucketTest() {
+
+        std::cout << "kdtree bucket test..." << std::endl;
+
+        PCDFile<double> pcd1("sample_data.csv");
+        PCDFile<double> pcd2("query_data.csv");
+
+        auto splitPointStrategy = std::make_shared<SplitPointSortStrategy<double>>();
+        auto splitAxisStrategy = std::make_shared<SplitAxisRoundRobinStrategy<double>>();
+
+        KDTree<double> sampleKDTree(pcd1, splitPointStrategy, splitAxisStrategy, 1);
+        assert(sampleKDTree.nodes() == sampleKDTree.points());
+
+        for (std::size_t bucketSize : {2, 4, 16, 64}) {
+
+            KDTree<double> bucketKDTree(pcd1, splitPointStrategy, splitAxisStrategy, 1, bucketSize);
+
+            assert(bucketKDTree.bucketSize() == bucketSize);
+            assert(bucketKDTree.points() == sampleKDTree.points());
+            assert(bucketKDTree.nodes() < sampleKDTree.nodes());
+            assert(bucketKDTree.bounds() == sampleKDTree.bounds());
+
+            std::size_t visited = 0;
+            std::size_t bucketVisited = 0;
+            std::vector<std::size_t> neighbors;
+
+            // buckets change how many nodes are visited, never what is found
+            for (Point<double> queryPoint : pcd2) {
+
+                std::tuple<std::size_t, double, std::size_t> t = sampleKDTree.queryNearestNeighbor(queryPoint);
+                std::tuple<std::size_t, double, std::size_t> b = bucketKDTree.queryNearestNeighbor(queryPoint);
+
+                assert(std::get<0>(b) == std::get<0>(t));
+                assert(std::get<1>(b) == std::get<1>(t));
+
+                visited += std::get<2>(t);
+                bucketVisited += std::get<2>(b);
+
+                assert(std::get<1>(bucketKDTree.queryKNearest(queryPoint, 5)) == std::get<1>(sampleKDTree.queryKNearest(queryPoint, 5)));
+                assert(std::get<1>(bucketKDTree.queryRadius(queryPoint, 0.2)) == std::get<1>(sampleKDTree.queryRadius(queryPoint, 0.2)));
+            }
+
+            assert(bucketVisited < visited);
+
+            Cell<double> box({0.2,0.3,0.1},{0.6,0.9,0.5});
+            bucketKDTree.queryBox(box.min(), box.max(), neighbors);
+            assert(neighbors.size() == std::get<0>(sampleKDTree.queryBox(box.min(), box.max())).size());
+
+            for (std::size_t index : neighbors) {
+                assert(box.contains(bucketKDTree.point(index)));
+            }
+
+            // buckets only fit in binary files, which read back the same tree
+            bool thrown = false;
+
+            try {
+                DotFileWriter<double>("tree.dot").writeFile(bucketKDTree);
+            } catch (const std::runtime_error& e) {
+                thrown = true;
+            }
+
+            assert(thrown);
+
+            BinaryFileWriter<double>("tree.kdt").writeFile(bucketKDTree);
+            BinaryFileReader<double> binaryfilereader("tree.kdt");
+            KDTree<double> mappedKDTree(binaryfilereader);
+
+            assert(mappedKDTree == bucketKDTree);
+            assert(mappedKDTree != sampleKDTree);
+            assert(mappedKDTree.bucketSize() == bucketSize);
+            assert(mappedKDTree.nodes() == bucketKDTree.nodes());
+            assert(std::get<1>(mappedKDTree.queryKNearest({0.1, -0.2, 0.3}, 7)) == std::get<1>(sampleKDTree.queryKNearest({0.1, -0.2, 0.3}, 7)));
+        }
+
+        std::remove("tree.kdt");
+    }
+
+    void presortTest() {
+
+        std::cout << "kdtree presort test..." << std::endl;
+
+        PCDFile<double> pcd1("sample_data.csv");
+        PCDFile<double> pcd2("query_data.csv");
+
+        for (std::string splitAxis : {"cycle", "range"}) {
+
+            auto splitAxisStrategy = SplitAxisStrategyFactory<double>::createSplitAxisStrategy(splitAxis);
+
+            KDTree<double> sortKDTree(pcd1, std::make_shared<SplitPointSortStrategy<double>>(), splitAxisStrategy);
+            KDTree<double> presortKDTree(pcd1, std::make_shared<SplitPointPresortStrategy<double>>(), splitAxisStrategy);
+
+            assert(presortKDTree == sortKDTree);
+        }
+
+        // a grid is full of ties, presorted trees still answer every query exactly, also with buckets
+        auto createGrid = []() {
+
+            PointCloud<double> grid(1000, 3);
+
+            for (int i = 0; i < 1000; i++) {
+                grid.addPoint({double(i % 10), double((i / 10) % 10), double(i / 100)});
+            }
+
+            return grid;
+        };
+
+        for (std::size_t bucketSize : {1, 4}) {
+
+            KDTree<double> presortKDTree(createGrid(), std::make_shared<SplitPointPresortStrategy<double>>(),
+                std::make_shared<SplitAxisRoundRobinStrategy<double>>(), 1, bucketSize);
+
+            assert(presortKDTree.points() == 1000);
+
+            for (int i = 0; i < 200; i++) {
+
+                Point<double> queryPoint({(i % 23) * 0.43, (i % 17) * 0.61, (i % 13) * 0.77});
+
+                double nearestDistance = std::numeric_limits<double>::max();
+                std::size_t inside = 0;
+
+                for (std::size_t j = 0; j < presortKDTree.points(); j++) {
+
+                    Point<double> p = presortKDTree.point(j);
+                    double d = std::sqrt(std::pow(p[0] - queryPoint[0], 2) + std::pow(p[1] - queryPoint[1], 2) + std::pow(p[2] - queryPoint[2], 2));
+
+                    nearestDistance = std::min(nearestDistance, d);
+                    if (d <= 1.5) inside++;
+                }
+
+                assert(std::abs(std::get<1>(presortKDTree.queryNearestNeighbor(queryPoint)) - nearestDistance) < 1e-9);
+                assert(std::get<0>(presortKDTree.queryRadius(queryPoint, 1.5)).size() == inside);
+            }
+        }
+    }
+
+    void pointRangeTest() {
+
+        std::cout << "kdtree point range test..." << std::endl;
+
+        // pcd files are read straight into the tree and build the same tree as through a pointcloud
+        PCDFile<double> pcd("sample_data.csv");
+        KDTree<double> sampleKDTree(pcd);
+        KDTree<double> pointCloudKDTree(PointCloud<double>(pcd),
+            std::make_shared<SplitPointSortStrategy<double>>(), std::make_shared<SplitAxisRoundRobinStrategy<double>>());
+
+        assert(sampleKDTree == pointCloudKDTree);
+        assert(sampleKDTree.points() == pcd.points());
+
+        for (std::size_t i = 0; i < sampleKDTree.points(); i++) {
+            assert(sampleKDTree.id(i) == pointCloudKDTree.id(i));
+        }
+
+        // any range of points, duplicates are only dropped on request and the first one is kept,
+        // points without an id are named by their position in the range
+        std::vector<Point<double>> points = {{1,2}, {3,4}, {1,2}, {1,5}, {3,4}, {1,2}};
+        points[3].id(30);
+
+        KDTree<double> rangeKDTree(points.begin(), points.end(),
+            std::make_shared<SplitPointSortStrategy<double>>(), std::make_shared<SplitAxisRoundRobinStrategy<double>>());
+
+        KDTree<double> uniqueKDTree(points.begin(), points.end(),
+            std::make_shared<SplitPointSortStrategy<double>>(), std::make_shared<SplitAxisRoundRobinStrategy<double>>(), 1, 1, true);
+
+        assert(rangeKDTree.points() == 6);
+        assert(rangeKDTree.dims() == 2);
+        assert(uniqueKDTree.points() == 3);
+
+        std::set<std::size_t> ids;
+
+        for (std::size_t i = 0; i < uniqueKDTree.points(); i++) {
+            ids.insert(uniqueKDTree.id(i));
+        }
+
+        assert((ids == std::set<std::size_t>({0, 1, 30})));
+        assert(std::get<0>(rangeKDTree.queryNearestNeighbor({1,5})) == 30);
+        assert(std::get<1>(uniqueKDTree.queryKNearest({1,2}, 2)) == std::vector<double>({0, std::sqrt(8.0)}));
+
+        // input iterators such as a pcd file's work too, and mixed dimensionality is refused
+        KDTree<double> pcdRangeKDTree(pcd.begin(), pcd.end(),
+            std::make_shared<SplitPointSortStrategy<double>>(), std::make_shared<SplitAxisRoundRobinStrategy<double>>());
+
+        assert(pcdRangeKDTree == sampleKDTree);
+
+        // splitting the rows of the file builds the tree the points of the file would, whatever the strategies
+        for (std::string splitPoint : {"sort", "select", "presort", "sliding"}) {
+
+            for (std::string splitAxis : {"cycle", "range", "variance", "cell"}) {
+
+                KDTree<double> rowsKDTree(pcd,
+                    SplitPointStrategyFactory<double>::createSplitPointStrategy(splitPoint),
+                    SplitAxisStrategyFactory<double>::createSplitAxisStrategy(splitAxis), 1, 4, true);
+
+                KDTree<double> pointsKDTree(pcd.begin(), pcd.end(),
+                    SplitPointStrategyFactory<double>::createSplitPointStrategy(splitPoint),
+                    SplitAxisStrategyFactory<double>::createSplitAxisStrategy(splitAxis), 1, 4, true);
+
+                assert(rowsKDTree == pointsKDTree);
+
+                for (std::size_t i = 0; i < rowsKDTree.points(); i++) {
+                    assert(rowsKDTree.id(i) == pointsKDTree.id(i));
+                }
+            }
+        }
+
+        // strategies that only look at points are handed copies of the rows
+        struct MedianStrategy : public SplitPointStrategy<double> {
+
+            Point<double> splitPoint(std::vector<Point<double>>& points, const std::size_t& dim, const std::size_t& begin, const std::size_t& end) {
+
+                auto mid = points.begin() + std::ceil((begin + end)/2.0);
+                std::nth_element(points.begin() + begin, mid, points.begin() + end + 1,
+                    [dim](const Point<double>& p1, const Point<double>& p2) {return p1[dim] < p2[dim];});
+
+                return std::move(*mid);
+            }
+        };
+
+        struct LastAxisStrategy : public SplitAxisStrategy<double> {
+
+            std::size_t splitAxis(const std::vector<Point<double>>& points, const std::size_t& begin, const std::size_t& end,
+                                  const std::size_t& depth, const Cell<double>& cell) const {
+
+                return (points[begin][0] < points[end][0]) ? 0 : points[begin].dims() - 1;
+            }
+        };
+
+        KDTree<double> copiedKDTree(pcd, std::make_shared<MedianStrategy>(), std::make_shared<LastAxisStrategy>(), 1);
+        KDTree<double> selectKDTree(pcd.begin(), pcd.end(), std::make_shared<SplitPointSelectStrategy<double>>(), std::make_shared<LastAxisStrategy>(), 1);
+
+        assert(copiedKDTree == selectKDTree);
+
+        for (std::size_t i = 0; i < copiedKDTree.points(); i++) {
+            assert(copiedKDTree.id(i) == selectKDTree.id(i));
+        }
+
+        bool thrown = false;
+        points.push_back({1,2,3});
+
+        try {
+            KDTree<double> mixedKDTree(points.begin(), points.end(),
+                std::make_shared<SplitPointSortStrategy<double>>(), std::make_shared<SplitAxisRoundRobinStrategy<double>>());
+        } catch (const std::runtime_error& e) {
+            thrown = true;
+        }
+
+        assert(thrown);
+    }
+
+    void parallelBuildTest() {
+
+        std::cout << "kdtree parallel build test..." << std::endl;
+
+        for (std::string splitPoint : {"sort", "select", "presort", "sliding"}) {
+
+            for (std::string splitAxis : {"cycle", "range", "variance", "cell"}) {
+
+                PCDFile<double> pcd("sample_data.csv");
+
+                KDTree<double> serialKDTree(pcd,
+                    SplitPointStrategyFactory<double>::createSplitPointStrategy(splitPoint),
+                    SplitAxisStrategyFactory<double>::createSplitAxisStrategy(splitAxis));
+
+                KDTree<double> parallelKDTree(pcd,
+                    SplitPointStrategyFactory<double>::createSplitPointStrategy(splitPoint),
+                    SplitAxisStrategyFactory<double>::createSplitAxisStrategy(splitAxis), 4);
+
+                assert(serialKDTree == parallelKDTree);
+            }
+        }
+
+        // large enough for subtrees to be forked onto the pool, with one strategy instance shared
+        // by builds running at the same time
+        const int n = 20000;
+
+        auto createPointCloud = [n]() {
+
+            PointCloud<double> pointCloud(n, 3);
+
+            for (int i = 0; i < n; i++) {
+                pointCloud.addPoint({double(i), double((i * 7919) % n), double((i * 104729) % n)});
+            }
+
+            return pointCloud;
+        };
+
+        for (std::string splitAxis : {"cycle", "range", "variance", "cell"}) {
+
+            auto splitPointStrategy = SplitPointStrategyFactory<double>::createSplitPointStrategy("select");
+            auto splitAxisStrategy = SplitAxisStrategyFactory<double>::createSplitAxisStrategy(splitAxis);
+
+            KDTree<double> serialKDTree(createPointCloud(), splitPointStrategy, splitAxisStrategy);
+            KDTree<double> parallelKDTree(createPointCloud(), splitPointStrategy, splitAxisStrategy, 4);
+
+            assert(serialKDTree == parallelKDTree);
+
+            std::vector<std::future<bool>> builds;
+
+            for (int i = 0; i < 2; i++) {
+                builds.push_back(std::async(std::launch::async, [&]() {
+                    return KDTree<double>(createPointCloud(), splitPointStrategy, splitAxisStrategy, 2) == serialKDTree;
+                }));
+            }
+
+            for (std::future<bool>& build : builds) {
+                assert(build.get());
+            }
+
+            // bucketed builds fork the same way
+            KDTree<double> serialBucketKDTree(createPointCloud(), splitPointStrategy, splitAxisStrategy, 1, 8);
+            KDTree<double> parallelBucketKDTree(createPointCloud(), splitPointStrategy, splitAxisStrategy, 4, 8);
+
+            assert(serialBucketKDTree == parallelBucketKDTree);
+
+            // without ties presorted builds split on the same medians as selecting them node by node
+            auto presortStrategy = SplitPointStrategyFactory<double>::createSplitPointStrategy("presort");
+
+            KDTree<double> serialPresortKDTree(createPointCloud(), presortStrategy, splitAxisStrategy);
+            KDTree<double> parallelPresortKDTree(createPointCloud(), presortStrategy, splitAxisStrategy, 4);
+
+            // the variance strategy samples large nodes, which depends on the order of their points
+            if (splitAxis != "variance") assert(serialPresortKDTree == serialKDTree);
+            assert(parallelPresortKDTree == serialPresortKDTree);
+        }
+    }
+
+    void fixedDimensionTest() {
+
+        std::cout << "kdtree fixed dimension test..." << std::endl;
+
+        PCDFile<double,3> pcd("sample_data.csv");
+        PCDFile<double> pcdDynamic("sample_data.csv");
+
+        KDTree<double,3> fixedKDTree(pcd);
+        KDTree<double> dynamicKDTree(pcdDynamic);
+
+        assert(fixedKDTree.dims() == 3);
+
+        KDTree<double,2> smallKDTree = {{1,2},{3,4},{5,6}};
+
+        DotFileWriter<double> dotfilewriter("tree.dot");
+        dotfilewriter.writeFile(smallKDTree);
+
+        DotFileReader<double> dotfilereader("tree.dot");
+        KDTree<double,2> smallKDTreeRead(dotfilereader);
+
+        assert(smallKDTree == smallKDTreeRead);
+
+        std::tuple<std::size_t, double, std::size_t> t1 = fixedKDTree.queryNearestNeighbor({0.5,0.5,0.5});
+        std::tuple<std::size_t, double, std::size_t> t2 = dynamicKDTree.queryNearestNeighbor({0.5,0.5,0.5});
+
+        assert(std::get<0>(t1) == std::get<0>(t2));
+        assert(std::abs(std::get<1>(t1) - std::get<1>(t2)) < epsilon);
+    }
+
     void queryNearestNeighborTest() {
 
         std::cout << "kdtree query nearest neighbor test" << std::endl;
     
-        std::tuple<Point<double>,double,int> nearest = kdtree.queryNearestNeighbor({3,4});
-        assert(std::get<0>(nearest) == Point<double>({3,4}));
+        std::tuple<std::size_t,double,int> nearest = kdtree.queryNearestNeighbor({3,4});
+        assert(std::get<0>(nearest) == 1);
         assert(std::get<1>(nearest) == 0);
 
         nearest = kdtree.queryNearestNeighbor({1,2});
-        assert(std::get<0>(nearest) == Point<double>({1,2}));
+        assert(std::get<0>(nearest) == 0);
         assert(std::get<1>(nearest) == 0);
 
         nearest = kdtree.queryNearestNeighbor({5,6});
-        assert(std::get<0>(nearest) == Point<double>({5,6}));
+        assert(std::get<0>(nearest) == 2);
         assert(std::get<1>(nearest) == 0);
 
         nearest = kdtree.queryNearestNeighbor({5.1,6});
-        assert(std::get<0>(nearest) == Point<double>({5,6}));
+        assert(std::get<0>(nearest) == 2);
         assert(std::abs(std::get<1>(nearest) - 0.1) < epsilon);
     }
 
+    void queryDimensionalityTest() {
+
+        std::cout << "kdtree query dimensionality test" << std::endl;
+
+        // a query point of another dimensionality is refused by every query, batches included
+        const Point<double> queryPoint({1.0});
+        const std::vector<Point<double>> queryPoints = {{3,4}, queryPoint};
+        KDTree<double>::QueryContext context(kdtree);
+        std::vector<std::size_t> buffer;
+
+        assert(refused([&] {kdtree.queryNearestNeighbor(queryPoint);}));
+        assert(refused([&] {kdtree.queryNearestNeighbor(queryPoint, context);}));
+        assert(refused([&] {kdtree.queryNearestNeighbor(queryPoints, 2);}));
+        assert(refused([&] {kdtree.queryKNearest(queryPoint, 2);}));
+        assert(refused([&] {kdtree.queryKNearest(queryPoints, 2, 2);}));
+        assert(refused([&] {kdtree.queryBestBinFirst(queryPoint, 2);}));
+        assert(refused([&] {kdtree.queryBestBinFirst(queryPoints, 2, 2);}));
+        assert(refused([&] {kdtree.queryRadius(queryPoint, 1);}));
+        assert(refused([&] {kdtree.queryRadius(queryPoint, 1, buffer);}));
+        assert(refused([&] {kdtree.queryRadius(queryPoint, 1, buffer, context);}));
+        assert(refused([&] {kdtree.queryBox(queryPoint, {4,4});}));
+        assert(refused([&] {kdtree.queryBox({0,0}, queryPoint, buffer);}));
+        assert(!refused([&] {kdtree.queryBox({0,0}, {4,4}, buffer);}));
+    }
+
+    template <typename Query>
+    static bool refused(const Query& query) {
+
+        try {
+            query();
+        } catch (const std::runtime_error& e) {
+            return true;
+        }
+
+        return false;
+    }
+
     void createTest() {
 
         std::cout << "kdtree create test" << std::endl;
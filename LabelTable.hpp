@@ -0,0 +1,78 @@
+#ifndef ROSSB83_LABEL_TABLE_HPP
+#define ROSSB83_LABEL_TABLE_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <cstdint>
+
+namespace rossb83 {
+
+ // string labels kept apart from the points they name, the label of id i is the i-th one added
+ //
+ // points and kdtrees only carry integer ids, so labels are looked up here when results are
+ // output rather than copied along with every point, all labels are packed back to back in one
+ // buffer so the table costs two allocations however many labels it holds
+ class LabelTable {
+
+  public:
+
+   // creates an empty table
+   LabelTable() : offsets_(1, 0) {}
+
+   // creates a table from a file holding one label per line, the label of id i on line i
+   LabelTable(const std::string& filename) : LabelTable() {
+
+    std::ifstream file(filename);
+
+    // possible user error here, file does not exist
+    if (!file) {
+
+     throw std::runtime_error("unable to open " + filename);
+    }
+
+    std::string label;
+
+    while (std::getline(file, label)) {
+     add(label);
+    }
+   }
+
+   // appends a label, output id of the label
+   std::size_t add(const std::string& label) {
+
+    chars_.insert(chars_.end(), label.begin(), label.end());
+    offsets_.push_back(chars_.size());
+
+    return offsets_.size() - 2;
+   }
+
+   // getter - label of an id
+   std::string label(const std::size_t& id) const {
+
+    // possible user error here, id was never added
+    if (id >= size()) {
+
+     throw std::runtime_error(std::to_string(id) + " has no label");
+    }
+
+    return std::string(chars_.begin() + offsets_[id], chars_.begin() + offsets_[id + 1]);
+   }
+
+   // getter - number of labels
+   std::size_t size() const {return offsets_.size() - 1;}
+
+  private:
+
+   // label i spans chars_[offsets_[i]] to chars_[offsets_[i+1]]
+   std::vector<std::uint64_t> offsets_;
+
+   // every label back to back, not null terminated
+   std::vector<char> chars_;
+
+ }; // class LabelTable
+
+} // namespace rossb83
+
+#endif // ROSSB83_LABEL_TABLE_HPP
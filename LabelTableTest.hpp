@@ -0,0 +1,86 @@
+#ifndef ROSSB83_LABEL_TABLE_TEST_HPP
+#define ROSSB83_LABEL_TABLE_TEST_HPP
+
+#include <assert.h>
+#include <cstdio>
+
+#include "LabelTable.hpp"
+
+namespace rossb83 {
+
+ class LabelTableTest {
+
+  public:
+
+   LabelTableTest() {
+
+    std::cout << "Running Label Table tests..." << std::endl;
+
+    addTest();
+    fileTest();
+   }
+
+  private:
+
+   void addTest() {
+
+    std::cout << "LabelTable add test..." << std::endl;
+
+    LabelTable labels;
+    assert(labels.size() == 0);
+
+    assert(labels.add("first") == 0);
+    assert(labels.add("") == 1);
+    assert(labels.add("third") == 2);
+
+    assert(labels.size() == 3);
+    assert(labels.label(0) == "first");
+    assert(labels.label(1).empty());
+    assert(labels.label(2) == "third");
+
+    bool thrown = false;
+
+    try {
+     labels.label(3);
+    } catch (const std::runtime_error& e) {
+     thrown = true;
+    }
+
+    assert(thrown);
+   }
+
+   void fileTest() {
+
+    std::cout << "LabelTable file test..." << std::endl;
+
+    {
+     std::ofstream file("labels.txt");
+     file << "alpha\nbeta gamma\n\ndelta";
+    }
+
+    LabelTable labels("labels.txt");
+
+    assert(labels.size() == 4);
+    assert(labels.label(0) == "alpha");
+    assert(labels.label(1) == "beta gamma");
+    assert(labels.label(2).empty());
+    assert(labels.label(3) == "delta");
+
+    std::remove("labels.txt");
+
+    bool thrown = false;
+
+    try {
+     LabelTable missing("labels.txt");
+    } catch (const std::runtime_error& e) {
+     thrown = true;
+    }
+
+    assert(thrown);
+   }
+
+ }; // class LabelTableTest
+
+} // namespace rossb83
+
+#endif // ROSSB83_LABEL_TABLE_TEST_HPP
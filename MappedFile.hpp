@@ -0,0 +1,99 @@
+#ifndef ROSSB83_MAPPED_FILE_HPP
+#define ROSSB83_MAPPED_FILE_HPP
+
+#include <string>
+#include <stdexcept>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ben's namespace
+namespace rossb83 {
+
+/*
+ * read only memory mapping of a whole file, unmapped when destroyed, the os pages the file in as
+ * it is touched so even very large files are never copied into the heap
+ */
+class MappedFile {
+
+    public:
+
+    /*
+     * maps file with filename
+     * input filename - file to be mapped
+     * input sequential - hint that the file will be read once front to back
+     */
+    MappedFile(const std::string& filename, bool sequential = false) : data_(nullptr), size_(0) {
+
+        int fd = ::open(filename.c_str(), O_RDONLY);
+
+        if (fd < 0) {
+            throw std::runtime_error("unable to open " + filename);
+        }
+
+        struct stat status;
+
+        if (::fstat(fd, &status) < 0) {
+
+            ::close(fd);
+            throw std::runtime_error("unable to stat " + filename);
+        }
+
+        size_ = status.st_size;
+
+        if (size_ > 0) {
+
+            void* data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+
+            if (data == MAP_FAILED) {
+
+                ::close(fd);
+                throw std::runtime_error("unable to map " + filename);
+            }
+
+            data_ = static_cast<const char*>(data);
+
+            if (sequential) ::madvise(data, size_, MADV_SEQUENTIAL);
+        }
+
+        // the mapping stays valid after the descriptor is closed
+        ::close(fd);
+    }
+
+    // don't allow copying a mapping, it would be unmapped twice
+    MappedFile(const MappedFile& other) = delete;
+
+    ~MappedFile() {
+
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+    }
+
+    /*
+     * getter - first byte of the file, null for an empty file
+     */
+    const char* data() const {return data_;}
+
+    /*
+     * getter - size of the file in bytes
+     */
+    std::size_t size() const {return size_;}
+
+    private:
+
+    /*
+     * mapped bytes of the file
+     */
+    const char* data_;
+
+    /*
+     * size of the file in bytes
+     */
+    std::size_t size_;
+
+}; // class MappedFile
+
+} // namespace rossb83
+
+#endif // ROSSB83_MAPPED_FILE_HPP
@@ -4,140 +4,208 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
 #include <stdexcept>
+#include <iterator>
+#include <charconv>
+
+#include "MappedFile.hpp"
 
 namespace rossb83 {
 
- template<typename T>
+ // pcd file will hold every point of a comma separated file, one point per line, the file is
+ // mapped and scanned once and every coordinate is parsed straight into one contiguous buffer
+ //
+ // example: the line 0.5,1.5,2.5 is the point (0.5,1.5,2.5), values may be wrapped in parentheses
+ //
+ // K is the compile time dimensionality of the points, 0 when chosen at runtime
+ template<typename T, std::size_t K = 0>
  class PCDFile {
 
   public:
 
-   PCDFile(std::string filename) {
+   PCDFile(std::string filename) : dims_(0), points_(0), filename_(filename) {
+
+    parse();
 
-    filename_ = filename;
-    countDims();
-    countPoints();
+    // a fixed dimension point can only hold rows with exactly K columns
+    if (K && dims_ != K) {
+
+     throw std::runtime_error(filename_ + " has " + std::to_string(dims_) + " columns, expected " + std::to_string(K));
+    }
    }
 
    size_t dims() const {return dims_;}
    size_t points() const {return points_;}
 
-   auto begin() {
-   
-    return LineInputIterator<Point<T>>(filename_, dims_);
+   // getter - coordinates of every point back to back, point i starts at coordinates()[i*dims()]
+   const std::vector<T>& coordinates() const {return coordinates_;}
+
+   auto begin() const {
+
+    return PointIterator(this, 0);
    }
 
    auto end() const {
-   
-    return LineInputIterator<Point<T>>();
+
+    return PointIterator(this, points_);
    }
 
   private:
 
-   void countPoints() {
+   // scans the mapped file once, the first row decides the dimensionality
+   void parse() {
+
+    MappedFile file(filename_, true);
+
+    const char* p = file.data();
+    const char* end = p + file.size();
+
+    // physical line of the file p is on, counting blank lines, for error messages
+    std::size_t line = 1;
+
+    while (p < end) {
+
+     // skip blank lines, also those holding nothing but whitespace
+     const char* blank = p;
+     skip(blank, end, " \t\r");
+
+     if (blank == end) break;
+
+     if (*blank == '\n') {
+
+      p = blank + 1;
+      line++;
+      continue;
+     }
+
+     std::size_t fields = 0;
+     const char* row = p;
+
+     while (true) {
+
+      skip(p, end, "( \t+");
+
+      double value;
+      std::from_chars_result result = std::from_chars(p, end, value);
+
+      // possible user error here, a field that is not a number
+      if (result.ec != std::errc()) {
+
+       throw std::runtime_error(filename_ + " line " + std::to_string(line) + " holds a value that is not a number");
+      }
+
+      coordinates_.push_back(static_cast<T>(value));
+      fields++;
+
+      p = result.ptr;
+      skip(p, end, ") \t\r");
+
+      if (p == end || *p == '\n') break;
+
+      if (*p++ != ',') {
+
+       throw std::runtime_error(filename_ + " line " + std::to_string(line) + " holds a malformed value");
+      }
+     }
+
+     if (points_ == 0) {
+
+      dims_ = fields;
+
+      // size the buffer from the length of the first row so it rarely has to grow
+      coordinates_.reserve((file.size() / (p - row + 1) + 1) * dims_);
+
+     } else if (fields != dims_) {
+
+      throw std::runtime_error(filename_ + " line " + std::to_string(line) + " has " + std::to_string(fields) +
+                               " columns, expected " + std::to_string(dims_));
+     }
 
-    std::ifstream file(filename_);
- 
-    // make newline characters visible
-    file.unsetf(std::ios_base::skipws);
+     points_++;
 
-    // count lines
-    points_ = std::count(
-     std::istream_iterator<char>(file),
-     std::istream_iterator<char>(),
-     '\n');
+     // step over the row's newline
+     if (p < end) {
 
+      ++p;
+      line++;
+     }
+    }
    }
 
-   void countDims() {
+   // advances p past any of the characters in chars
+   static void skip(const char*& p, const char* end, const char* chars) {
 
-    std::ifstream file(filename_);
- 
-    std::string row;
-    std::getline(file,row);
-    dims_ = std::count(row.begin(),row.end(),',') + 1;
+    while (p < end && std::char_traits<char>::find(chars, std::char_traits<char>::length(chars), *p)) ++p;
    }
 
    std::size_t dims_;
    std::size_t points_;
    std::string filename_;
 
-   // custom iterator code below largely adapated from:
-   // http://stackoverflow.com/questions/1567082/how-do-i-iterate-over-cin-line-by-line-in-c
-   template <class PointT = Point<T>>
-   class LineInputIterator {
+   // every coordinate of the file in row order
+   std::vector<T> coordinates_;
 
-   public:
-    typedef typename std::string::value_type char_type;
-    typedef typename std::string::traits_type traits_type;
-    typedef std::basic_istream<char_type, traits_type> istream_type;
+   // iterates over the points of the file, each point is copied out of the coordinate buffer
+   class PointIterator {
 
-    LineInputIterator(): is_(0) {}
+   public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef Point<T,K> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Point<T,K>* pointer;
+    typedef const Point<T,K>& reference;
 
-    LineInputIterator(std::string const& filename, std::size_t const&  dims) : 
-        point_(Point<T>(dims)) {
+    PointIterator(const PCDFile* pcdfile, const std::size_t& index) :
+        pcdfile_(pcdfile), index_(index), point_(pcdfile->dims_) {
 
-        file_.open(filename);
-        is_ = &file_;
-        ++*this;
+     load();
     }
 
-    LineInputIterator(LineInputIterator&& in) {
+    const Point<T,K>& operator*() const { return point_; }
 
-        ;
-    }
-
-    const Point<T>& operator*() const { return point_; }
+    const Point<T,K>* operator->() const { return &point_; }
 
-    const Point<T>* operator->() const { return &point_; }
+    PointIterator& operator++() {
 
-    LineInputIterator<Point<T>>& operator++() {
-     
-     std::string line;
-        
-     if (is_ && !getline(*is_, line)) {
-      is_ = NULL;
-     }
-
-     std::istringstream iss(line);
-
-     iss >> point_;
+     ++index_;
+     load();
 
      return *this;
     }
-    
-    LineInputIterator<Point<T>> operator++(int) {
 
-     LineInputIterator<Point<T>> prev(*this);
+    PointIterator operator++(int) {
+
+     PointIterator prev(*this);
      ++*this;
      return prev;
     }
 
-    bool operator!=(const LineInputIterator<Point<T>>& other) const {
-        
-     return is_ != other.is_;
-    }
+    bool operator!=(const PointIterator& other) const {
 
-    bool operator!=(const LineInputIterator<Point<T>>&& other) const {
-        
-     return is_ != other.is_;
-    }
-    
-    bool operator==(const LineInputIterator<Point<T>>& other) const {
-        
-     return !(*this != other);
+     return index_ != other.index_;
     }
 
-    bool operator==(const LineInputIterator<Point<T>>&& other) const {
-        
+    bool operator==(const PointIterator& other) const {
+
      return !(*this != other);
     }
 
    private:
-    std::ifstream file_;
-    istream_type* is_;
-    Point<T> point_;
+
+    // copies the current point out of the coordinate buffer
+    void load() {
+
+     if (index_ < pcdfile_->points_) {
+
+      auto first = pcdfile_->coordinates_.begin() + index_ * pcdfile_->dims_;
+      std::copy(first, first + pcdfile_->dims_, point_.begin());
+     }
+    }
+
+    const PCDFile* pcdfile_;
+    std::size_t index_;
+    Point<T,K> point_;
   };
  }; // class PCDFile
 } // namespace rossb83
@@ -18,6 +18,8 @@ namespace rossb83 {
    
     createTest();
     iteratorTest();
+    formatTest();
+    malformedTest();
    }
 
   private:
@@ -50,6 +52,59 @@ namespace rossb83 {
     assert(pointCounter == 1000);
    }
 
+   void formatTest() {
+
+    std::cout << "PCDFile format test..." << std::endl;
+
+    // parentheses, blank and whitespace only lines, windows line endings and a missing final newline are all accepted
+    std::ofstream("pcdtest.csv") << "(1,2.5,-3)\r\n\n \t\n 4e1, +5 ,6\n7,8,9";
+
+    PCDFile<double> pcdfile("pcdtest.csv");
+
+    assert(pcdfile.dims() == 3);
+    assert(pcdfile.points() == 3);
+    assert(pcdfile.coordinates() == std::vector<double>({1,2.5,-3,40,5,6,7,8,9}));
+    assert(*pcdfile.begin() == Point<double>({1,2.5,-3}));
+
+    PCDFile<int,3> fixedpcdfile("pcdtest.csv");
+    assert(fixedpcdfile.coordinates() == std::vector<int>({1,2,-3,40,5,6,7,8,9}));
+
+    std::remove("pcdtest.csv");
+   }
+
+   void malformedTest() {
+
+    std::cout << "PCDFile malformed test..." << std::endl;
+
+    for (std::string contents : {"1,2,3\n4,5\n", "1,2,3\n4,x,6\n", "1,2,3\n4;5;6\n"}) {
+
+     std::ofstream("pcdtest.csv") << contents;
+     bool thrown = false;
+
+     try {
+      PCDFile<double> pcdfile("pcdtest.csv");
+     } catch (const std::runtime_error& e) {
+      thrown = true;
+     }
+
+     assert(thrown);
+    }
+
+    // errors name the line of the file, counting blank and whitespace only lines
+    std::ofstream("pcdtest.csv") << "1,2,3\n\n \t \r\n4,5,6\n7,x,9\n";
+    std::string message;
+
+    try {
+     PCDFile<double> pcdfile("pcdtest.csv");
+    } catch (const std::runtime_error& e) {
+     message = e.what();
+    }
+
+    assert(message.find("line 5 ") != std::string::npos);
+
+    std::remove("pcdtest.csv");
+   }
+
  }; // class pcdfiletest
 
 } // namespace rossb83 
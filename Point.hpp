@@ -18,6 +18,7 @@
 #include <math.h>
 #include <complex>
 #include <stdexcept>
+#include <array>
 
 namespace rossb83 {
 
@@ -25,18 +26,28 @@ namespace rossb83 {
  //
  // example: (1,2) is a point of dimension 2
  //
+ // K is the dimensionality fixed at compile time, Point<T,3> keeps its values inline in a
+ // std::array, while the default K = 0 is sized at runtime and keeps its values on the heap
+ template<typename T, std::size_t K = 0>
+ class Point;
+
+ // runtime dimensioned point
+ //
  // restrictions: currently the dimension of a point is constant
  //  and is not adjustable beyond the creation of the point instance
  template<typename T>
- class Point {
+ class Point<T, 0> {
 
   public:
 
+   // id of a point that was never given one
+   static constexpr std::size_t NO_ID = std::numeric_limits<std::size_t>::max();
+
    // creates an empty point
-   Point() : dims_(0) {}
+   Point() : id_(NO_ID), dims_(0) {}
 
    // creates a point at origin of specified dimensionality
-   Point(const size_t& dims) {
+   Point(const size_t& dims) : id_(NO_ID) {
     
     // dims value is authoratative for size
     dims_ = dims;
@@ -45,7 +56,7 @@ namespace rossb83 {
 
    // creates a point of specified values
    Point(const std::initializer_list<T>& vals) : 
-    data_(vals), dims_(vals.size()) {}
+    id_(NO_ID), data_(vals), dims_(vals.size()) {}
 
    // creates a point from r-value specified point
    Point(Point<T>&& other) {
@@ -53,8 +64,7 @@ namespace rossb83 {
     // other's data_ is now empty vector
     this->data_ = std::move(other.data_);
 
-    // other's label is now empty string
-    this->label_ = std::move(other.label_);
+    this->id_ = other.id_;
     
     // grab other's previous size and set it to zero
     this->dims_ = other.dims_;
@@ -66,7 +76,7 @@ namespace rossb83 {
    
     this->data_ = other.data_;
     this->dims_ = other.dims_;
-    this->label_ = other.label_;
+    this->id_ = other.id_;
    }
 
    // getter - retrieve element of point at specified dimension
@@ -99,12 +109,20 @@ namespace rossb83 {
    Point<T>& operator=(Point<T> point) {
 
     this->data_ = std::move(point.data_);
-    this->label_ = std::move(point.label_);
+    this->id_ = point.id_;
     this->dims_ = point.dims_;
     point.dims_ = 0;
     return *this;
    }
 
+   // exchanges the values of two points without copying either
+   friend void swap(Point<T>& a, Point<T>& b) {
+
+    a.data_.swap(b.data_);
+    std::swap(a.id_, b.id_);
+    std::swap(a.dims_, b.dims_);
+   }
+
    bool operator!=(const Point<T>& p) const {
    
     return !(*this == p);
@@ -177,20 +195,23 @@ namespace rossb83 {
 
    // non-const end iterator
    typename std::vector<T>::iterator end() {return data_.end();}
+
+   // getter - values of the point back to back
+   const T* data() const {return data_.data();}
    
    // getter - dimensionality of point
    size_t dims() const {return dims_;}
 
-   // setter - optional label
-   void label(std::string label) {this->label_ = label;}
+   // setter - integer id naming the point, such as its row in the file it was read from
+   void id(const std::size_t& id) {this->id_ = id;}
 
-   // getter - optional label
-   std::string label() const {return label_;}
+   // getter - integer id naming the point, NO_ID until it is given one
+   std::size_t id() const {return id_;}
 
   private:
 
-   // optional label
-   std::string label_;
+   // integer id, string labels are kept in a LabelTable indexed by it
+   std::size_t id_;
   
    // each index in this dataype refers to a dimension in this point
    std::vector<T> data_;
@@ -200,29 +221,173 @@ namespace rossb83 {
  
  }; // class Point
 
+ // compile time dimensioned point, values live inline so copies and temporaries never touch
+ // the heap and loops over the dimensions have a constant trip count the compiler can unroll
+ //
+ // element access is unchecked, dimensionality is validated once when the point is created
+ template<typename T, std::size_t K>
+ class Point {
+
+  public:
+
+   // id of a point that was never given one
+   static constexpr std::size_t NO_ID = std::numeric_limits<std::size_t>::max();
+
+   // creates a point at origin
+   Point() : id_(NO_ID), data_() {}
+
+   // creates a point at origin, dims must agree with the compile time dimensionality
+   Point(const size_t& dims) : id_(NO_ID), data_() {
+
+    if (dims != K) {
+
+     throw std::runtime_error(std::to_string(dims) + " does not match dimensionality " + std::to_string(K));
+    }
+   }
+
+   // creates a point of specified values
+   Point(const std::initializer_list<T>& vals) : id_(NO_ID), data_() {
+
+    if (vals.size() != K) {
+
+     throw std::runtime_error(std::to_string(vals.size()) + " does not match dimensionality " + std::to_string(K));
+    }
+
+    std::copy(vals.begin(), vals.end(), data_.begin());
+   }
+
+   // getter - retrieve element of point at specified dimension
+   T operator[](const std::size_t& i) const {return data_[i];}
+
+   // setter - update element of point at specified dimension
+   T& operator[](const std::size_t& i) {return data_[i];}
+
+   // exchanges the values of two points without copying either
+   friend void swap(Point<T,K>& a, Point<T,K>& b) {
+
+    a.data_.swap(b.data_);
+    std::swap(a.id_, b.id_);
+   }
+
+   bool operator!=(const Point<T,K>& p) const {
+
+    return !(*this == p);
+   }
+
+   bool operator==(const Point<T,K>& p) const {
+
+    return data_ == p.data_;
+   }
+
+   // subtracts points element by element, ie (3,4) - (1,2) = (2,2)
+   friend Point<T,K> operator-(const Point<T,K>& lhs, const Point<T,K>& rhs) {
+
+    Point<T,K> p;
+    std::transform(lhs.begin(),lhs.end(),rhs.begin(),p.begin(),std::minus<T>());
+
+    return p;
+   }
+
+   // creates a point streamed in the format (p1,p2,p3,...,pN) or p1,p2,p3...pN
+   friend std::istream& operator>>(std::istream& ss, Point<T,K>& p) {
+
+    std::string data;
+    std::size_t dim = 0;
+
+    while(getline(ss,data,',')) {
+
+     // possible user error here, more values than dimensions
+     if (dim >= K) {
+
+      throw std::runtime_error(std::to_string(dim) + " exceeds dimensionality");
+     }
+
+     if (data.at(0) == '(') data = data.substr(1);
+     if (data.at(data.size() - 1) == ')') data = data.substr(0,data.size() - 1);
+
+     p[dim++] = static_cast<T>(std::stod(data));
+    }
+
+    return ss;
+   }
+
+   // streams a point in format (p1,p2,p3,...,pN)
+   friend std::ostream& operator<<(std::ostream& ss, const Point<T,K>& p) {
+
+    ss << "(";
+
+    for (size_t i = 0; i < K; i++) {
+
+     ss << p[i];
+     ss << ((i < (K-1)) ? "," : "");
+    }
+
+    ss << ")";
+    return ss;
+   }
+
+   // const begin iterator
+   typename std::array<T,K>::const_iterator begin() const {return data_.begin();}
+
+   // begin iterator
+   typename std::array<T,K>::iterator begin() {return data_.begin();}
+
+   // const end iterator
+   typename std::array<T,K>::const_iterator end() const {return data_.end();}
+
+   // non-const end iterator
+   typename std::array<T,K>::iterator end() {return data_.end();}
+
+   // getter - values of the point back to back
+   const T* data() const {return data_.data();}
+
+   // getter - dimensionality of point
+   constexpr size_t dims() const {return K;}
+
+   // setter - integer id naming the point, such as its row in the file it was read from
+   void id(const std::size_t& id) {this->id_ = id;}
+
+   // getter - integer id naming the point, NO_ID until it is given one
+   std::size_t id() const {return id_;}
+
+  private:
+
+   // integer id, string labels are kept in a LabelTable indexed by it
+   std::size_t id_;
+
+   // each index in this dataype refers to a dimension in this point
+   std::array<T,K> data_;
+
+ }; // class Point
+
 } // namespace rossb83
 
 // add special definitions to std relating to Point
 namespace std {
 
  // define the norm of a point as its inner product with itself
- template<typename T>
- double norm(const rossb83::Point<T>& p) {
+ template<typename T, std::size_t K>
+ double norm(const rossb83::Point<T,K>& p) {
   
     return inner_product(p.begin(), p.end(), p.begin(), 0.0);
  }
 
- template <typename T>
- struct hash<rossb83::Point<T>> {
-   size_t operator()(const rossb83::Point<T>& p) const {
+ template <typename T, std::size_t K>
+ struct hash<rossb83::Point<T,K>> {
+   size_t operator()(const rossb83::Point<T,K>& p) const {
 
     // empty point always hashes to zero
     if (p.dims() == 0) return 0;
 
-    // TODO: come up with better hash function, currently only taking
-    // first element into account
+    // every coordinate is mixed in, points in one plane or on one line must not collide
     hash<T> h;
-    return h(p[0]);
+    size_t seed = 0;
+
+    for (const T& value : p) {
+     seed ^= h(value) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+
+    return seed;
    }
  }; // class hash<Point>
 
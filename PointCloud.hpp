@@ -1,51 +1,93 @@
 #ifndef ROSSB83_POINTCLOUD_HPP
 #define ROSSB83_POINTCLOUD_HPP
 
-#include <unordered_set>
+#include <vector>
+#include <unordered_map>
 #include <limits>
 #include <tuple>
 #include <cmath>
+#include <cstdint>
 
 #include "PCDFile.hpp"
 #include "Point.hpp"
+#include "DistanceKernel.hpp"
 
 namespace rossb83 {
 
- template<typename T>
+ // decides which points a pointcloud treats as duplicates, by default every point is kept, exact
+ // drops a point whose coordinates all equal those of a point already in the cloud and voxel keeps
+ // only the first point to land in every cube of space of the given size
+ class DedupPolicy {
+
+  public:
+
+   enum Mode {NONE, EXACT, VOXEL};
+
+   static DedupPolicy none() {return DedupPolicy(NONE, 0.0);}
+
+   static DedupPolicy exact() {return DedupPolicy(EXACT, 0.0);}
+
+   static DedupPolicy voxel(const double& size) {
+
+    // possible user error here, voxels must have a size
+    if (!(size > 0.0)) {
+
+     throw std::runtime_error("voxel size must be positive");
+    }
+
+    return DedupPolicy(VOXEL, size);
+   }
+
+   Mode mode() const {return mode_;}
+
+   double voxelSize() const {return voxelSize_;}
+
+  private:
+
+   DedupPolicy(const Mode& mode, const double& voxelSize) : mode_(mode), voxelSize_(voxelSize) {}
+
+   Mode mode_;
+   double voxelSize_;
+
+ }; // class DedupPolicy
+
+ // points are stored back to back in insertion order, duplicates are only looked for when the
+ // dedup policy asks for it, through an index from the hash of every point's key to the points
+ // with that hash
+ //
+ // K is the compile time dimensionality of the points, 0 when chosen at runtime
+ template<typename T, std::size_t K = 0>
  class PointCloud {
 
   public:
-   PointCloud(const std::size_t& capacity, const std::size_t& dims) {
-   
-    data_.reserve(10*capacity);
-    capacity_ = capacity;
-    dims_ = dims;
-    points_ = 0;
+   PointCloud(const std::size_t& capacity, const std::size_t& dims, const DedupPolicy& policy = DedupPolicy::none()) :
+    dims_(dims), points_(0), capacity_(capacity), policy_(policy) {
+
+    data_.reserve(capacity);
+    if (policy_.mode() != DedupPolicy::NONE) index_.reserve(capacity);
    }
 
     /*
-     * create a pointcloud with input from a pcdfile
-     */ 
-    PointCloud(PCDFile<T>& pcdfile) : PointCloud(pcdfile.points(), pcdfile.dims()) {
-   
-        int label = 0;
- 
-        for (Point<T> p : pcdfile) {
-        
-            p.label(std::to_string(label++));
+     * create a pointcloud with input from a pcdfile, every point's id is its row in the file
+     */
+    PointCloud(PCDFile<T,K>& pcdfile, const DedupPolicy& policy = DedupPolicy::none()) : PointCloud(pcdfile.points(), pcdfile.dims(), policy) {
+
+        std::size_t row = 0;
+
+        for (Point<T,K> p : pcdfile) {
+
+            p.id(row++);
             addPoint(std::move(p));
         }
     }
 
-   PointCloud(const std::initializer_list<Point<T>>& vals) : 
-    data_(vals), capacity_(vals.size()), points_(vals.size()) {
-  
-    dims_ = vals.begin()->dims();
-    
+   PointCloud(const std::initializer_list<Point<T,K>>& vals) :
+    dims_(vals.begin()->dims()), points_(vals.size()), capacity_(vals.size()), policy_(DedupPolicy::none()), data_(vals) {
+
     for(int i = 0; i < vals.size()-1; i++) {
- 
+
      if ((vals.begin() + i)->dims() != (vals.begin() + i + 1)->dims()) {
-     
+
       throw std::runtime_error("Point dimensions must match");
      }
     }
@@ -56,26 +98,31 @@ namespace rossb83 {
    PointCloud(PointCloud& other) = delete;
 
    // moves a pointcloud to a new instance
-   PointCloud(PointCloud&& other) {
+   PointCloud(PointCloud&& other) : policy_(other.policy_) {
 
     this->data_ = std::move(other.data_);
+    this->index_ = std::move(other.index_);
     this->capacity_ = other.capacity_;
     this->dims_ = other.dims_;
     this->points_ = other.points_;
 
+    other.index_.clear();
     other.capacity_ = 0;
     other.dims_ = 0;
     other.points_ = 0;
    }
 
    // assigns this pointcloud's values to another pointcloud's values
-   PointCloud<T>& operator=(PointCloud<T> rhs) {
-    
+   PointCloud<T,K>& operator=(PointCloud<T,K> rhs) {
+
     this->data_ = std::move(rhs.data_);
-    this->capacity_ = rhs.capacity;
+    this->index_ = std::move(rhs.index_);
+    this->policy_ = rhs.policy_;
+    this->capacity_ = rhs.capacity_;
     this->dims_ = rhs.dims_;
     this->points_ = rhs.points_;
 
+    rhs.index_.clear();
     rhs.capacity_ = 0;
     rhs.dims_ = 0;
     rhs.points_ = 0;
@@ -83,67 +130,90 @@ namespace rossb83 {
     return *this;
    }
 
-   // inserts a point into the pointcloud
-   bool addPoint(const Point<T>& p) {
+   // inserts a point into the pointcloud, false when the pointcloud is full or the policy finds it a duplicate
+   bool addPoint(Point<T,K> p) {
 
     if (p.dims() != dims_) {
      throw std::runtime_error("Point dimensionality does not match");
     }
 
-    if (points_ < capacity_) {
+    if (points_ >= capacity_) return false;
+
+    if (policy_.mode() != DedupPolicy::NONE) {
+
+     std::size_t h = hash(p);
 
-     points_++;
-     data_.insert(p);
-     return true;
+     if (find(p, h) != data_.size()) return false;
+
+     index_.insert(std::make_pair(h, data_.size()));
     }
 
-    return false;
+    data_.push_back(std::move(p));
+    points_++;
+
+    return true;
    }
 
-    std::tuple<Point<T>, double, std::size_t> queryNearestNeighbor(const Point<T>& queryPoint) {
+    std::tuple<Point<T,K>, double, std::size_t> queryNearestNeighbor(const Point<T,K>& queryPoint) {
 
         // initialize nearest neighbor/distance as empty point at distance infinity
-        Point<T> nearestNeighbor = Point<T>();
+        Point<T,K> nearestNeighbor = Point<T,K>();
         double nearestDistance = std::numeric_limits<double>::max();
         std::size_t numnodesvisited = 0;
 
-        // lambda to update nearest neighbor
-        auto updateNearestNeighbor = [&queryPoint, &nearestNeighbor, &nearestDistance](const Point<T> p) {
- 
-            double queryDistance = std::norm(queryPoint - p); 
-    
+        // lambda to update nearest neighbor, distances stop being summed once they exceed the best so far
+        auto updateNearestNeighbor = [&queryPoint, &nearestNeighbor, &nearestDistance](const Point<T,K>& p) {
+
+            double queryDistance = DistanceKernel<T>::squaredDistance(queryPoint.data(), p.data(), p.dims(), nearestDistance);
+
             if(queryDistance < nearestDistance) {
-    
+
                 nearestDistance = queryDistance;
                 nearestNeighbor = p;
-            }   
-        };  
+            }
+        };
+
+        for (const Point<T,K>& p : data_) {
 
-        for (Point<T> p : data_) {
-        
             updateNearestNeighbor(p);
             numnodesvisited++;
-        }  
+        }
 
         return std::make_tuple(nearestNeighbor, std::sqrt(nearestDistance), numnodesvisited);
     }
 
-   bool containsPoint(const Point<T>& p) {
-   
-    return (data_.find(p) != data_.end());
+   // true iff a point with the same coordinates is in the pointcloud, a lookup in the dedup index
+   // when the policy keeps one and a scan otherwise, voxel policies match any point in the same voxel
+   bool containsPoint(const Point<T,K>& p) const {
+
+    if (p.dims() != dims_) return false;
+
+    if (policy_.mode() != DedupPolicy::NONE) return find(p, hash(p)) != data_.size();
+
+    for (const Point<T,K>& q : data_) {
+     if (q == p) return true;
+    }
+
+    return false;
+   }
+
+   // moves every point out, in insertion order, leaving the pointcloud empty
+   std::vector<Point<T,K>> release() {
+
+    std::vector<Point<T,K>> points = std::move(data_);
+
+    data_.clear();
+    index_.clear();
+    points_ = 0;
+
+    return points;
    }
 
    // const begin iterator
-   typename std::unordered_set<Point<T>>::const_iterator begin() const {return data_.begin();}
- 
-   // begin iterator
-   typename std::unordered_set<Point<T>>::iterator begin() {return data_.begin();}
- 
+   typename std::vector<Point<T,K>>::const_iterator begin() const {return data_.begin();}
+
    // const end iterator
-   typename std::unordered_set<Point<T>>::const_iterator end() const {return data_.end();}
- 
-   // non-const end iterator
-   typename std::unordered_set<Point<T>>::iterator end() {return data_.end();}
+   typename std::vector<Point<T,K>>::const_iterator end() const {return data_.end();}
 
    std::size_t dims() const {return dims_;}
 
@@ -151,11 +221,65 @@ namespace rossb83 {
 
    std::size_t capacity() const {return capacity_;}
 
+   const DedupPolicy& policy() const {return policy_;}
+
   private:
+
+   // voxel of a coordinate, the cube of space of the policy's size that holds it
+   std::int64_t voxel(const T& value) const {
+
+    return static_cast<std::int64_t>(std::floor(static_cast<double>(value) / policy_.voxelSize()));
+   }
+
+   // hash of a point's key, every coordinate or every voxel index
+   std::size_t hash(const Point<T,K>& p) const {
+
+    if (policy_.mode() == DedupPolicy::EXACT) return std::hash<Point<T,K>>()(p);
+
+    std::hash<std::int64_t> h;
+    std::size_t seed = 0;
+
+    for (const T& value : p) {
+     seed ^= h(voxel(value)) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+
+    return seed;
+   }
+
+   // true iff two points have the same key
+   bool sameKey(const Point<T,K>& a, const Point<T,K>& b) const {
+
+    if (policy_.mode() == DedupPolicy::EXACT) return a == b;
+
+    for (std::size_t i = 0; i < dims_; i++) {
+     if (voxel(a[i]) != voxel(b[i])) return false;
+    }
+
+    return true;
+   }
+
+   // index of the point with the same key as p, whose key hashes to h, or data_.size() if there is none
+   std::size_t find(const Point<T,K>& p, const std::size_t& h) const {
+
+    auto range = index_.equal_range(h);
+
+    for (auto it = range.first; it != range.second; ++it) {
+     if (sameKey(data_[it->second], p)) return it->second;
+    }
+
+    return data_.size();
+   }
+
    std::size_t dims_;
    std::size_t points_;
    std::size_t capacity_;
-   std::unordered_set<Point<T>> data_;
+   DedupPolicy policy_;
+
+   // every point in insertion order
+   std::vector<Point<T,K>> data_;
+
+   // hash of a point's key to the index of the point, only filled when deduplicating
+   std::unordered_multimap<std::size_t, std::size_t> index_;
 
  }; // class pointcloud
 
@@ -21,6 +21,7 @@ namespace rossb83 {
     moveTest();
     moveAssignmentTest();
     bruteForceNearestNeighborTest();
+    dedupTest();
    }
 
   private:
@@ -89,6 +90,63 @@ namespace rossb83 {
     assert(p == Point<int>({3,4}));
    }
 
+   void dedupTest() {
+
+    std::cout << "PointCloud dedup test..." << std::endl;
+
+    // every point is kept unless a policy says otherwise
+    PointCloud<double> all(10, 2);
+    assert(all.addPoint({1,2}));
+    assert(all.addPoint({1,2}));
+    assert(all.points() == 2);
+    assert(all.containsPoint({1,2}));
+
+    PointCloud<double> exact(10, 2, DedupPolicy::exact());
+    assert(exact.addPoint({1,2}));
+    assert(!exact.addPoint({1,2}));
+    assert(exact.addPoint({1,3}));
+    assert(exact.points() == 2);
+    assert(exact.containsPoint({1,3}));
+    assert(!exact.containsPoint({1,4}));
+
+    // first point in every voxel wins
+    PointCloud<double> voxel(10, 2, DedupPolicy::voxel(1.0));
+    Point<double> first({0.2,0.3});
+    first.id(42);
+    assert(voxel.addPoint(first));
+    assert(!voxel.addPoint({0.9,0.1}));
+    assert(voxel.addPoint({1.1,0.1}));
+    assert(voxel.addPoint({-0.1,0.1}));
+    assert(voxel.points() == 3);
+    assert(voxel.begin()->id() == 42);
+    assert(voxel.containsPoint({0.5,0.5}));
+
+    // a structured grid in one scan plane, every point shares its first coordinate
+    PointCloud<double> grid(250000, 3, DedupPolicy::exact());
+
+    for (int i = 0; i < 250000; i++) {
+     assert(grid.addPoint({0, double(i % 500), double(i / 500)}));
+    }
+
+    assert(!grid.addPoint({0, 499, 499}));
+    assert(grid.points() == 250000);
+
+    // the points move out in insertion order
+    std::vector<Point<double>> points = grid.release();
+    assert(points.size() == 250000 && points[501] == Point<double>({0,1,1}));
+    assert(grid.points() == 0);
+
+    bool thrown = false;
+
+    try {
+     DedupPolicy::voxel(0);
+    } catch (const std::runtime_error& e) {
+     thrown = true;
+    }
+
+    assert(thrown);
+   }
+
    void insertTest() {
    
     std::cout << "PointCloud Insert Test" << std::endl;    
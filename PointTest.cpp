@@ -1,23 +1,52 @@
 #include <iostream>
 
+// count every allocation so the tests can check what is allocated
+#define ROSSB83_COUNT_ALLOCATIONS
+#include "AllocationCounter.hpp"
+
+// record traversal statistics so the tests can check them
+#define ROSSB83_QUERY_STATS
+
 #include "PointTest.hpp"
 #include "PointCloudTest.hpp"
+#include "LabelTableTest.hpp"
 #include "PCDFileTest.hpp"
+#include "CellTest.hpp"
+#include "ThreadPoolTest.hpp"
+#include "DistanceKernelTest.hpp"
 #include "SplitAxisRoundRobinStrategyTest.hpp"
 #include "SplitAxisRangeStrategyTest.hpp"
+#include "SplitAxisVarianceStrategyTest.hpp"
+#include "SplitAxisCellStrategyTest.hpp"
 #include "SplitPointSortStrategyTest.hpp"
 #include "SplitPointSelectStrategyTest.hpp"
+#include "SplitPointPresortStrategyTest.hpp"
+#include "SplitPointSlidingMidpointStrategyTest.hpp"
 #include "KDTreeTest.hpp"
+#include "AllocationCounterTest.hpp"
+#include "QueryStatsTest.hpp"
+#include "BuildMonitorTest.hpp"
 
 int main(int argc, char* argv[]) {
 
  rossb83::PointTest pointtest;
  rossb83::PointCloudTest pointcloudtest;
+ rossb83::LabelTableTest labeltabletest;
  rossb83::PCDFileTest pcdfiletest;
+ rossb83::CellTest celltest;
+ rossb83::ThreadPoolTest threadpooltest;
+ rossb83::DistanceKernelTest distancekerneltest;
  rossb83::SplitAxisRoundRobinStrategyTest splitAxisRRTest;
  rossb83::SplitPointSortStrategyTest splitPointSortTest;
  rossb83::SplitPointSelectStrategyTest splitPointSelectStrategyTest;
+ rossb83::SplitPointPresortStrategyTest splitPointPresortStrategyTest;
+ rossb83::SplitPointSlidingMidpointStrategyTest splitPointSlidingMidpointStrategyTest;
  rossb83::SplitAxisRangeStrategyTest splitAxisRangeStrategyTest;
+ rossb83::SplitAxisVarianceStrategyTest splitAxisVarianceStrategyTest;
+ rossb83::SplitAxisCellStrategyTest splitAxisCellStrategyTest;
  rossb83::KDTreeTest kdTreeTest;
+ rossb83::AllocationCounterTest allocationCounterTest;
+ rossb83::QueryStatsTest queryStatsTest;
+ rossb83::BuildMonitorTest buildMonitorTest;
  return 0;
 }
@@ -21,12 +21,16 @@ namespace rossb83 {
     copyTest();
     assignmentCopyTest();
     assignmentMoveTest();
+    swapTest();
     updateTest();
     minusOperatorTest();
     equalityOperatorTest();
     ostreamOperatorTest();
     normTest();
     hashTest();
+    fixedCreateTest();
+    fixedMinusOperatorTest();
+    fixedNormTest();
    }
 
   private:
@@ -111,6 +115,29 @@ namespace rossb83 {
     assert(a[3] == 7);
    }
 
+   void swapTest() {
+
+    std::cout << "Point Swap Test..." << std::endl;
+
+    Point<int> a = {1,2,3};
+    Point<int> b = {4,5,6,7};
+    a.id(7);
+
+    swap(a, b);
+
+    assert(a == Point<int>({4,5,6,7}));
+    assert(b == Point<int>({1,2,3}));
+    assert(a.dims() == 4 && b.dims() == 3);
+    assert(a.id() == Point<int>::NO_ID && b.id() == 7);
+
+    Point<int,2> c = {1,2};
+    Point<int,2> d = {3,4};
+
+    swap(c, d);
+
+    assert(c[0] == 3 && d[0] == 1);
+   }
+
    void updateTest() {
 
     std::cout << "Point Update Test..." << std::endl;
@@ -170,6 +197,57 @@ namespace rossb83 {
     // interesting... point hashes to different values
     // in clang vs g++
     //assert(h({0.1337,2.384,100}) == 4593985070451970907);
+
+    // every coordinate counts, not just the first
+    assert(h({1,2,3}) == h({1,2,3}));
+    assert(h({1,2,3}) != h({1,2,4}));
+    assert(h({1,2,3}) != h({1,3,2}));
+   }
+
+   void fixedCreateTest() {
+
+    std::cout << "Fixed Point create test..." << std::endl;
+
+    Point<int,3> a;
+    Point<int,3> b = {1,2,3};
+
+    assert(a.dims() == 3);
+    assert(b.dims() == 3);
+
+    for (int val : a) {
+     assert(val == 0);
+    }
+
+    assert(b[0] == 1);
+    assert(b[1] == 2);
+    assert(b[2] == 3);
+
+    bool thrown = false;
+
+    try {
+     Point<int,3> c = {1,2};
+    } catch (const std::runtime_error& e) {
+     thrown = true;
+    }
+
+    assert(thrown);
+   }
+
+   void fixedMinusOperatorTest() {
+
+    std::cout << "Fixed Point minus test..." << std::endl;
+
+    Point<int,3> a;
+    Point<int,3> p = a - Point<int,3>({1,2,3});
+
+    assert((p == Point<int,3>({-1,-2,-3})));
+    assert(p != a);
+   }
+
+   void fixedNormTest() {
+
+    std::cout << "Fixed Point norm test..." << std::endl;
+    assert(std::norm(Point<int,3>({1,2,3})) == 14);
    }
 
    const Point<int> p1 = Point<int>(5);
@@ -0,0 +1,288 @@
+#ifndef ROSSB83_QUERY_STATS_HPP
+#define ROSSB83_QUERY_STATS_HPP
+
+#include <array>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+
+// ben's namespace
+namespace rossb83 {
+
+/*
+ * true iff kdtree traversals record QueryStats, turned on by defining ROSSB83_QUERY_STATS before
+ * including kdtree.hpp, the same way in every translation unit of a program
+ *
+ * every counter in a traversal is guarded by if constexpr on this, so without the macro the
+ * counting code is never compiled and queries cost exactly what they did before
+ */
+#ifdef ROSSB83_QUERY_STATS
+static constexpr bool QUERY_STATS_ENABLED = true;
+#else
+static constexpr bool QUERY_STATS_ENABLED = false;
+#endif
+
+/*
+ * work done by one traversal of a kdtree, all zero when QUERY_STATS_ENABLED is false
+ */
+struct QueryStats {
+
+    /*
+     * number of nodes whose points were checked
+     */
+    std::size_t nodesVisited_ = 0;
+
+    /*
+     * number of far branches skipped because the splitting hyperplane lies outside the search radius
+     */
+    std::size_t branchesPruned_ = 0;
+
+    /*
+     * number of far branches searched because the search radius crosses the splitting hyperplane
+     */
+    std::size_t branchesDescended_ = 0;
+
+    /*
+     * number of visited nodes without children, single points or buckets
+     */
+    std::size_t leavesScanned_ = 0;
+
+    /*
+     * number of points whose distance to the query point was computed
+     */
+    std::size_t distanceEvaluations_ = 0;
+
+    /*
+     * most nodes on the traversal stack at once, never more than the tree height plus one
+     */
+    std::size_t maxStackDepth_ = 0;
+
+}; // struct QueryStats
+
+/*
+ * histogram of non negative integers in power of two buckets, bucket 0 counts zeros and bucket b
+ * counts values in [2^(b-1), 2^b), so any 64 bit value fits with a fixed 65 buckets
+ */
+class Histogram {
+
+    public:
+
+    static const std::size_t BUCKETS = 65;
+
+    /*
+     * counts one value
+     */
+    void add(const std::uint64_t& value) {
+
+        counts_[bucket(value)]++;
+        count_++;
+        sum_ += value;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    /*
+     * getter - number of values counted
+     */
+    std::uint64_t count() const {return count_;}
+
+    /*
+     * getter - smallest value counted, 0 if none were
+     */
+    std::uint64_t min() const {return (count_ > 0) ? min_ : 0;}
+
+    /*
+     * getter - largest value counted
+     */
+    std::uint64_t max() const {return max_;}
+
+    /*
+     * getter - average value counted, 0 if none were
+     */
+    double mean() const {return (count_ > 0) ? static_cast<double>(sum_) / count_ : 0.0;}
+
+    /*
+     * getter - number of values counted in bucket b
+     */
+    std::uint64_t counts(const std::size_t& b) const {return counts_[b];}
+
+    /*
+     * getter - smallest value of bucket b
+     */
+    static std::uint64_t lower(const std::size_t& b) {return (b == 0) ? 0 : (std::uint64_t(1) << (b - 1));}
+
+    /*
+     * getter - largest value of bucket b
+     */
+    static std::uint64_t upper(const std::size_t& b) {return (b == 0) ? 0 : (b == BUCKETS - 1) ? std::numeric_limits<std::uint64_t>::max() : (std::uint64_t(1) << b) - 1;}
+
+    /*
+     * getter - bucket a value is counted in, one more than the index of its highest set bit
+     */
+    static std::size_t bucket(std::uint64_t value) {
+
+        std::size_t b = 0;
+
+        while (value > 0) {
+
+            value >>= 1;
+            b++;
+        }
+
+        return b;
+    }
+
+    private:
+
+    std::array<std::uint64_t, BUCKETS> counts_{};
+
+    std::uint64_t count_ = 0;
+    std::uint64_t sum_ = 0;
+    std::uint64_t min_ = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max_ = 0;
+
+}; // class Histogram
+
+/*
+ * aggregates the QueryStats and latencies of many queries into one histogram per metric, so a
+ * tree that degrades for a query distribution shows up as a shifted or longer tailed histogram
+ */
+class QueryStatistics {
+
+    public:
+
+    /*
+     * names of the metrics, in the order they are written
+     */
+    static const std::vector<std::string>& metrics() {
+
+        static const std::vector<std::string> names = {"latency_ns", "nodes_visited", "branches_pruned", "branches_descended",
+                                                       "leaves_scanned", "distance_evaluations", "max_stack_depth"};
+        return names;
+    }
+
+    /*
+     * counts one query
+     * input stats - work done by the query
+     * input latency - nanoseconds the query took
+     */
+    void add(const QueryStats& stats, const std::uint64_t& latency) {
+
+        histograms_[0].add(latency);
+        histograms_[1].add(stats.nodesVisited_);
+        histograms_[2].add(stats.branchesPruned_);
+        histograms_[3].add(stats.branchesDescended_);
+        histograms_[4].add(stats.leavesScanned_);
+        histograms_[5].add(stats.distanceEvaluations_);
+        histograms_[6].add(stats.maxStackDepth_);
+    }
+
+    /*
+     * getter - histogram of a metric
+     * input metric - one of metrics()
+     */
+    const Histogram& histogram(const std::string& metric) const {
+
+        auto found = std::find(metrics().begin(), metrics().end(), metric);
+
+        // possible user error here, metric does not exist
+        if (found == metrics().end()) {
+
+            throw std::runtime_error("no query metric named " + metric);
+        }
+
+        return histograms_[found - metrics().begin()];
+    }
+
+    /*
+     * getter - number of queries counted
+     */
+    std::uint64_t queries() const {return histograms_[0].count();}
+
+    /*
+     * writes a summary and the non empty buckets of every metric as a json object
+     */
+    void writeJson(std::ostream& out) const {
+
+        out << "{\n  \"queries\": " << queries() << ",\n  \"enabled\": " << (QUERY_STATS_ENABLED ? "true" : "false") << ",\n  \"metrics\": {\n";
+
+        for (std::size_t m = 0; m < metrics().size(); m++) {
+
+            const Histogram& h = histograms_[m];
+
+            out << "    \"" << metrics()[m] << "\": {\"min\": " << h.min() << ", \"max\": " << h.max() << ", \"mean\": " << h.mean() << ", \"buckets\": [";
+
+            bool first = true;
+
+            for (std::size_t b = 0; b < Histogram::BUCKETS; b++) {
+
+                if (h.counts(b) == 0) continue;
+
+                out << (first ? "" : ", ") << "{\"lower\": " << Histogram::lower(b) << ", \"upper\": " << Histogram::upper(b) << ", \"count\": " << h.counts(b) << "}";
+                first = false;
+            }
+
+            out << "]}" << ((m + 1 < metrics().size()) ? ",\n" : "\n");
+        }
+
+        out << "  }\n}\n";
+    }
+
+    /*
+     * writes the non empty buckets of every metric as csv rows of metric,lower,upper,count
+     */
+    void writeCsv(std::ostream& out) const {
+
+        out << "metric,lower,upper,count\n";
+
+        for (std::size_t m = 0; m < metrics().size(); m++) {
+
+            for (std::size_t b = 0; b < Histogram::BUCKETS; b++) {
+
+                if (histograms_[m].counts(b) == 0) continue;
+
+                out << metrics()[m] << "," << Histogram::lower(b) << "," << Histogram::upper(b) << "," << histograms_[m].counts(b) << '\n';
+            }
+        }
+    }
+
+    /*
+     * writes the statistics to a file, as csv if its name ends in .csv and as json otherwise
+     */
+    void writeFile(const std::string& filename) const {
+
+        std::ofstream out(filename);
+
+        // possible user error here, file can not be created
+        if (!out) {
+
+            throw std::runtime_error("unable to open " + filename);
+        }
+
+        static const std::string CSV = ".csv";
+
+        if (filename.size() >= CSV.size() && filename.compare(filename.size() - CSV.size(), CSV.size(), CSV) == 0) {
+            writeCsv(out);
+        } else {
+            writeJson(out);
+        }
+    }
+
+    private:
+
+    /*
+     * one histogram per metric, in the order of metrics()
+     */
+    std::array<Histogram, 7> histograms_;
+
+}; // class QueryStatistics
+
+} // namespace rossb83
+
+#endif // ROSSB83_QUERY_STATS_HPP
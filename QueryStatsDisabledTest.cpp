@@ -0,0 +1,13 @@
+#include <iostream>
+
+// built without ROSSB83_QUERY_STATS, unlike PointTest, so the traversals that record nothing are
+// compiled and tested too
+
+#include "Point.hpp"
+#include "QueryStatsTest.hpp"
+
+int main(int argc, char* argv[]) {
+
+ rossb83::QueryStatsTest queryStatsTest;
+ return 0;
+}
@@ -0,0 +1,168 @@
+#ifndef ROSSB83_QUERY_STATS_TEST_HPP
+#define ROSSB83_QUERY_STATS_TEST_HPP
+
+#include <assert.h>
+#include <sstream>
+
+#include "QueryStats.hpp"
+#include "kdtree.hpp"
+
+namespace rossb83 {
+
+ class QueryStatsTest {
+
+  public:
+
+   QueryStatsTest() {
+
+    std::cout << "Running Query Stats tests..." << std::endl;
+
+    histogramTest();
+    traversalTest();
+    writeTest();
+   }
+
+  private:
+
+   void histogramTest() {
+
+    std::cout << "QueryStats histogram test..." << std::endl;
+
+    // bucket b holds [2^(b-1), 2^b)
+    assert(Histogram::bucket(0) == 0);
+    assert(Histogram::bucket(1) == 1);
+    assert(Histogram::bucket(2) == 2);
+    assert(Histogram::bucket(3) == 2);
+    assert(Histogram::bucket(4) == 3);
+    assert(Histogram::bucket(std::numeric_limits<std::uint64_t>::max()) == Histogram::BUCKETS - 1);
+
+    for (std::size_t b = 1; b < Histogram::BUCKETS; b++) {
+
+     assert(Histogram::bucket(Histogram::lower(b)) == b);
+     assert(Histogram::bucket(Histogram::upper(b)) == b);
+    }
+
+    Histogram histogram;
+    assert(histogram.count() == 0 && histogram.min() == 0 && histogram.mean() == 0.0);
+
+    for (std::uint64_t value : {0, 5, 6, 7, 100}) histogram.add(value);
+
+    assert(histogram.count() == 5);
+    assert(histogram.min() == 0);
+    assert(histogram.max() == 100);
+    assert(histogram.mean() == 118.0 / 5);
+    assert(histogram.counts(0) == 1);
+    assert(histogram.counts(3) == 3);
+    assert(histogram.counts(7) == 1);
+   }
+
+   void traversalTest() {
+
+    std::cout << "QueryStats traversal test..." << std::endl;
+
+    // PointTest records traversal statistics and QueryStatsDisabledTest runs the same checks without them
+    PCDFile<double> pcd1("sample_data.csv");
+    PCDFile<double> pcd2("query_data.csv");
+
+    auto splitPointStrategy = std::make_shared<SplitPointSortStrategy<double>>();
+    auto splitAxisStrategy = std::make_shared<SplitAxisRoundRobinStrategy<double>>();
+
+    KDTree<double> sampleKDTree(pcd1, splitPointStrategy, splitAxisStrategy);
+    KDTree<double> bucketKDTree(pcd1, splitPointStrategy, splitAxisStrategy, 1, 8);
+
+    KDTree<double>::QueryContext sampleContext(sampleKDTree);
+    KDTree<double>::QueryContext bucketContext(bucketKDTree);
+
+    for (const Point<double>& queryPoint : pcd2) {
+
+     std::pair<std::size_t, double> nearest = sampleKDTree.queryNearestNeighbor(queryPoint, sampleContext);
+     const QueryStats& stats = sampleContext.stats();
+
+     // recording never changes the answer
+     assert(sampleKDTree.id(nearest.first) == std::get<0>(sampleKDTree.queryNearestNeighbor(queryPoint)));
+
+     if (!QUERY_STATS_ENABLED) {
+
+      // without ROSSB83_QUERY_STATS the counting code is not compiled and nothing is recorded
+      assert(stats.nodesVisited_ == 0 && stats.branchesPruned_ == 0 && stats.branchesDescended_ == 0);
+      assert(stats.leavesScanned_ == 0 && stats.distanceEvaluations_ == 0 && stats.maxStackDepth_ == 0);
+      continue;
+     }
+
+     // the counters agree with the nodes the query reports visiting
+     assert(stats.nodesVisited_ == std::get<2>(sampleKDTree.queryNearestNeighbor(queryPoint)));
+     assert(stats.nodesVisited_ > 0);
+
+     // one point per node, every visited node checks exactly one point
+     assert(stats.distanceEvaluations_ == stats.nodesVisited_);
+     assert(stats.leavesScanned_ > 0 && stats.leavesScanned_ <= stats.nodesVisited_);
+
+     // every visited node except the root was reached by descending into it or the best path below one
+     assert(stats.branchesDescended_ < stats.nodesVisited_);
+     assert(stats.maxStackDepth_ > 0 && stats.maxStackDepth_ <= sampleKDTree.height() + 1);
+
+     // a bucket scans several points per node
+     bucketKDTree.queryNearestNeighbor(queryPoint, bucketContext);
+     assert(bucketContext.stats().distanceEvaluations_ >= bucketContext.stats().nodesVisited_);
+     assert(bucketContext.stats().maxStackDepth_ <= bucketKDTree.height() + 1);
+    }
+
+    // a context that ran nothing has done no work
+    KDTree<double>::QueryContext fresh(sampleKDTree);
+    assert(fresh.stats().nodesVisited_ == 0);
+   }
+
+   void writeTest() {
+
+    std::cout << "QueryStats write test..." << std::endl;
+
+    QueryStatistics statistics;
+
+    QueryStats stats;
+    stats.nodesVisited_ = 12;
+    stats.branchesPruned_ = 3;
+    stats.distanceEvaluations_ = 12;
+    stats.maxStackDepth_ = 5;
+
+    statistics.add(stats, 1500);
+    statistics.add(stats, 3000);
+
+    assert(statistics.queries() == 2);
+    assert(statistics.histogram("latency_ns").max() == 3000);
+    assert(statistics.histogram("nodes_visited").counts(Histogram::bucket(12)) == 2);
+    assert(statistics.histogram("branches_descended").counts(0) == 2);
+
+    bool thrown = false;
+
+    try {
+     statistics.histogram("missing");
+    } catch (const std::runtime_error& e) {
+     thrown = true;
+    }
+
+    assert(thrown);
+
+    // one csv row per non empty bucket, latencies fall in two buckets and every other metric in one
+    std::ostringstream csv;
+    statistics.writeCsv(csv);
+
+    assert(csv.str().find("metric,lower,upper,count\n") == 0);
+    assert(csv.str().find("latency_ns,1024,2047,1\n") != std::string::npos);
+    assert(csv.str().find("latency_ns,2048,4095,1\n") != std::string::npos);
+    assert(csv.str().find("nodes_visited,8,15,2\n") != std::string::npos);
+    std::string rows = csv.str();
+    assert(std::count(rows.begin(), rows.end(), '\n') == 1 + 2 + 6);
+
+    std::ostringstream json;
+    statistics.writeJson(json);
+
+    assert(json.str().find("\"queries\": 2") != std::string::npos);
+    assert(json.str().find(QUERY_STATS_ENABLED ? "\"enabled\": true" : "\"enabled\": false") != std::string::npos);
+    assert(json.str().find("\"max_stack_depth\": {\"min\": 5, \"max\": 5") != std::string::npos);
+   }
+
+ }; // class QueryStatsTest
+
+} // namespace rossb83
+
+#endif // ROSSB83_QUERY_STATS_TEST_HPP
@@ -0,0 +1,60 @@
+#ifndef ROSSB83_SPLIT_AXIS_CELL_STRATEGY_HPP
+#define ROSSB83_SPLIT_AXIS_CELL_STRATEGY_HPP
+
+#include <vector>
+#include <iostream>
+
+#include "SplitAxisStrategy.hpp"
+
+namespace rossb83 {
+
+ // this split axis strategy will split the longest side of the cell a node covers, rather than the
+ // axis its points spread the most along, it is the axis the sliding midpoint split point strategy
+ // is meant for, cutting the longest side in half keeps the sides of every cell within a constant
+ // factor of each other however the points are clustered
+ //
+ // the points are not looked at, ties go to the lowest axis
+ template<typename T, std::size_t K = 0>
+ class SplitAxisCellStrategy : public SplitAxisStrategy<T,K> {
+
+  public:
+
+   std::size_t splitAxis(const std::vector<Point<T,K>>& points, const std::size_t& begin, const std::size_t& end,
+                         const std::size_t& depth, const Cell<T,K>& cell) const {
+
+    return longest(cell);
+   }
+
+   std::size_t splitAxis(const T* coordinates, const std::size_t& dims, const std::vector<std::uint32_t>& rows, const std::size_t& begin,
+                         const std::size_t& end, const std::size_t& depth, const Cell<T,K>& cell) const {
+
+    return longest(cell);
+   }
+
+  private:
+
+   // helper function to find the axis of the longest side of a cell
+   static std::size_t longest(const Cell<T,K>& cell) {
+
+    std::size_t splitaxis = 0;
+    T maxsidesofar = 0;
+
+    for (std::size_t axis = 0; axis < cell.min().dims(); axis++) {
+
+     T side = cell.max()[axis] - cell.min()[axis];
+
+     if (side > maxsidesofar) {
+
+      splitaxis = axis;
+      maxsidesofar = side;
+     }
+    }
+
+    return splitaxis;
+   }
+
+ };// class SplitAxisCellStrategy
+
+} // namespace rossb83
+
+#endif // ROSSB83_SPLIT_AXIS_CELL_STRATEGY_HPP
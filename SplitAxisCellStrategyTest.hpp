@@ -0,0 +1,51 @@
+#ifndef ROSSB83_SPLIT_AXIS_CELL_STRATEGY_TEST_HPP
+#define ROSSB83_SPLIT_AXIS_CELL_STRATEGY_TEST_HPP
+
+#include <assert.h>
+
+#include "SplitAxisCellStrategy.hpp"
+
+namespace rossb83 {
+
+ class SplitAxisCellStrategyTest {
+
+  public:
+
+   SplitAxisCellStrategyTest() {
+
+    std::cout << "Running SplitAxis Cell Strategy tests..." << std::endl;
+
+    cellTest();
+   }
+
+  private:
+
+   void cellTest() {
+
+    std::cout << "split axis cell test..." << std::endl;
+    strategy = std::make_shared<SplitAxisCellStrategy<int>>();
+
+    // the points spread the most along axis 0, the cell is longest along axis 2
+    std::vector<Point<int>> points = {{0,1,2},{9,2,3}};
+
+    assert(strategy->splitAxis(points,0,1,0,Cell<int>({0,0,0},{10,5,20})) == 2);
+    assert(strategy->splitAxis(points,0,1,0,Cell<int>({0,0,0},{10,15,5})) == 1);
+
+    // ties go to the lowest axis, and a cell without extent splits the first
+    assert(strategy->splitAxis(points,0,1,0,Cell<int>({0,0,0},{10,10,10})) == 0);
+    assert(strategy->splitAxis(points,0,1,0,Cell<int>({3,3,3},{3,3,3})) == 0);
+
+    // the rows of a pcd file are split the same way
+    std::vector<std::uint32_t> rows = {0, 1};
+    const int coordinates[] = {0,1,2,9,2,3};
+
+    assert(strategy->splitAxis(coordinates,3,rows,0,1,0,Cell<int>({0,0,0},{10,5,20})) == 2);
+   }
+
+   std::shared_ptr<SplitAxisStrategy<int>> strategy;
+
+ }; // class SplitAxisCellStrategyTest
+
+} // namespace rossb83
+
+#endif // ROSSB83_SPLIT_AXIS_CELL_STRATEGY_TEST_HPP
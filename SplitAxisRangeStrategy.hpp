@@ -14,30 +14,33 @@
 
 namespace rossb83 {
 
-template<typename T>
-class SplitAxisRangeStrategy : public SplitAxisStrategy<T> {
+template<typename T, std::size_t K = 0>
+class SplitAxisRangeStrategy : public SplitAxisStrategy<T,K> {
 
 public:
 
     // split axis based on largest range
-    std::size_t splitAxis(const std::vector<Point<T>>& points, const std::size_t& begin, const std::size_t& end) {
+    // depth and cell are not needed, the range is taken over the points themselves
+    std::size_t splitAxis(const std::vector<Point<T,K>>& points, const std::size_t& begin, const std::size_t& end,
+                          const std::size_t& depth, const Cell<T,K>& cell) const {
 
 	// point dimensions in input point set
-    	std::size_t dims = points[0].dims();
+    	std::size_t dims = points[begin].dims();
 
         // state variables to keep track of max range and its corresponding dimension
         std::size_t splitaxis = 0;
-        std::size_t maxrangesofar = 0;
+        T maxrangesofar = 0;
 
 	for (std::size_t axis = 0; axis < dims; axis++) {
 
-            Point<T> min = *(std::min_element(points.begin() + begin, points.begin() + end + 1,
-                [&axis](Point<T> p1, Point<T> p2) {return p1[axis] < p2[axis];}));
+            const Point<T,K>& min = *(std::min_element(points.begin() + begin, points.begin() + end + 1,
+                [&axis](const Point<T,K>& p1, const Point<T,K>& p2) {return p1[axis] < p2[axis];}));
 
-            Point<T> max = *(std::max_element(points.begin() + begin, points.begin() + end + 1,
-                [&axis](Point<T> p1, Point<T> p2) {return p1[axis] < p2[axis];}));
+            const Point<T,K>& max = *(std::max_element(points.begin() + begin, points.begin() + end + 1,
+                [&axis](const Point<T,K>& p1, const Point<T,K>& p2) {return p1[axis] < p2[axis];}));
 
-            std::size_t range = max[axis] - min[axis];
+            // kept in the coordinate type, ranges below 1 would truncate to 0 as an integer
+            T range = max[axis] - min[axis];
 
             if (range > maxrangesofar) {
 
@@ -49,6 +52,34 @@ public:
         return splitaxis;
     }
 
+    // split axis based on largest range of the rows of a pcd file
+    std::size_t splitAxis(const T* coordinates, const std::size_t& dims, const std::vector<std::uint32_t>& rows, const std::size_t& begin,
+                          const std::size_t& end, const std::size_t& depth, const Cell<T,K>& cell) const {
+
+        std::size_t splitaxis = 0;
+        T maxrangesofar = 0;
+
+        for (std::size_t axis = 0; axis < dims; axis++) {
+
+            auto less = [coordinates, &dims, &axis](const std::uint32_t& r1, const std::uint32_t& r2) {
+                return coordinates[r1 * dims + axis] < coordinates[r2 * dims + axis];
+            };
+
+            std::uint32_t min = *std::min_element(rows.begin() + begin, rows.begin() + end + 1, less);
+            std::uint32_t max = *std::max_element(rows.begin() + begin, rows.begin() + end + 1, less);
+
+            T range = coordinates[max * dims + axis] - coordinates[min * dims + axis];
+
+            if (range > maxrangesofar) {
+
+                splitaxis = axis;
+                maxrangesofar = range;
+            }
+        }
+
+        return splitaxis;
+    }
+
 };// class Split
 
 } // namespace rossb83
@@ -24,16 +24,21 @@ namespace rossb83 {
 
     std::cout << "split axis range test..." << std::endl;
     strategy = std::make_shared<SplitAxisRangeStrategy<int>>();
+    Cell<int> cell(3);
     
-    std::size_t axis1 = strategy->splitAxis({{0,1,2},{3,4,5},{11,7,8}},0,2);
-    std::size_t axis2 = strategy->splitAxis({{0,1,2},{3,7,5},{11,7,8}},0,1);
-    std::size_t axis3 = strategy->splitAxis({{0,1,2},{3,7,9},{11,7,8}},0,1);
-    std::size_t axis4 = strategy->splitAxis({{0,1,2},{3,7,9},{11,7,8}},0,0);
+    std::size_t axis1 = strategy->splitAxis({{0,1,2},{3,4,5},{11,7,8}},0,2,0,cell);
+    std::size_t axis2 = strategy->splitAxis({{0,1,2},{3,7,5},{11,7,8}},0,1,0,cell);
+    std::size_t axis3 = strategy->splitAxis({{0,1,2},{3,7,9},{11,7,8}},0,1,0,cell);
+    std::size_t axis4 = strategy->splitAxis({{0,1,2},{3,7,9},{11,7,8}},0,0,0,cell);
  
     assert(axis1 == 0);
     assert(axis2 == 1);
     assert(axis3 == 2);
     assert(axis4 == 0);
+
+    // ranges below 1 still count
+    Cell<double> fractionalCell(2);
+    assert(SplitAxisRangeStrategy<double>().splitAxis({{0.1,0.2},{0.2,0.9}},0,1,0,fractionalCell) == 1);
    }
 
    std::shared_ptr<SplitAxisStrategy<int>> strategy;
@@ -10,31 +10,23 @@ namespace rossb83 {
 
  // this split axis strategy will split the axis based on the tree level, every level will have the
  // the same axis split, and the axis split will increment by one each level and then start over
- template<typename T>
- class SplitAxisRoundRobinStrategy : public SplitAxisStrategy<T> {
+ template<typename T, std::size_t K = 0>
+ class SplitAxisRoundRobinStrategy : public SplitAxisStrategy<T,K> {
 
-  private:
-   // the number of nodes so far
-   std::size_t nodes_;
-
-   // the number of levels so far
-   std::size_t level_;
+  public:
 
-   // the previous axis split used
-   std::size_t axis_;
+   // every level of the tree splits on the axis after the one of the level above, so the axis
+   // follows from the depth of the node alone
+   std::size_t splitAxis(const std::vector<Point<T,K>>& points, const std::size_t& begin, const std::size_t& end,
+                         const std::size_t& depth, const Cell<T,K>& cell) const {
 
-  public:
-   SplitAxisRoundRobinStrategy() : nodes_(0), axis_(0), level_(1) {}
+    return depth % points[begin].dims();
+   }
 
-   // since a kdtree is always balanced, this algorithm can tell what level it is on based
-   // on the number of nodes processed so far and the previous level
-   std::size_t splitAxis(const std::vector<Point<T>>& points, const std::size_t& begin, const std::size_t& end) {
-    if (++nodes_ >= pow(2,level_)) {
+   std::size_t splitAxis(const T* coordinates, const std::size_t& dims, const std::vector<std::uint32_t>& rows, const std::size_t& begin,
+                         const std::size_t& end, const std::size_t& depth, const Cell<T,K>& cell) const {
 
-     level_++;
-     axis_ = ++axis_ % points[begin].dims();
-    }
-    return axis_;
+    return depth % dims;
    }
 
  };// class Split
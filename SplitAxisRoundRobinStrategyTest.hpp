@@ -25,23 +25,17 @@ namespace rossb83 {
     std::cout << "split axis round robin test..." << std::endl;
     strategy = std::make_shared<SplitAxisRoundRobinStrategy<int>>();
     
-    std::size_t axis1 = strategy->splitAxis({{0,1,2},{1,2,2}},0,1);
-    std::size_t axis2 = strategy->splitAxis({{0,1,2},{1,2,2}},0,1);
-    std::size_t axis3 = strategy->splitAxis({{0,1,2},{1,2,2}},0,1);
-    std::size_t axis4 = strategy->splitAxis({{0,1,2},{1,2,2}},0,1);
-    std::size_t axis5 = strategy->splitAxis({{0,1,2},{1,2,2}},0,1);
-    std::size_t axis6 = strategy->splitAxis({{0,1,2},{1,2,2}},0,1);
-    std::size_t axis7 = strategy->splitAxis({{0,1,2},{1,2,2}},0,1);
-    std::size_t axis8 = strategy->splitAxis({{0,1,2},{1,2,2}},0,1);
-   
-    assert(axis1 == 0);
-    assert(axis2 == 1);
-    assert(axis3 == 1);
-    assert(axis4 == 2);
-    assert(axis5 == 2);
-    assert(axis6 == 2);
-    assert(axis7 == 2);
-    assert(axis8 == 0);
+    std::vector<Point<int>> points = {{0,1,2},{1,2,2}};
+    Cell<int> cell(3);
+
+    // the axis depends on the depth alone, whatever order the calls come in
+    assert(strategy->splitAxis(points,0,1,0,cell) == 0);
+    assert(strategy->splitAxis(points,0,1,1,cell) == 1);
+    assert(strategy->splitAxis(points,0,1,2,cell) == 2);
+    assert(strategy->splitAxis(points,0,1,3,cell) == 0);
+    assert(strategy->splitAxis(points,0,1,7,cell) == 1);
+    assert(strategy->splitAxis(points,0,1,1,cell) == 1);
+    assert(strategy->splitAxis(points,0,1,0,cell) == 0);
    }
 
    std::shared_ptr<SplitAxisStrategy<int>> strategy;
@@ -17,16 +17,41 @@
 #include <limits>
 #include <math.h>
 #include <complex>
+#include <cstdint>
+
+#include "Cell.hpp"
 
 namespace rossb83 {
 
- // this abstract class is an interface to determine which axis the kdtree will split on
- template<typename T>
+ // this abstract class is an interface to determine which axis the kdtree will split on, K is the
+ // compile time dimensionality of the points or 0 when chosen at runtime
+ template<typename T, std::size_t K = 0>
  class SplitAxisStrategy {
 
   public:
-   // this pure virtual method is an interface to the axis selection strategy
-   virtual std::size_t splitAxis(const std::vector<Point<T>>& points, const std::size_t& begin, const std::size_t& end) = 0;
+   // this pure virtual method is an interface to the axis selection strategy, it picks the axis
+   // to split points begin through end on given the depth of the node in the tree (0 at the root)
+   // and the cell of space the node covers, strategies hold no state between calls so one
+   // instance may be shared by any number of builds running at the same time
+   virtual std::size_t splitAxis(const std::vector<Point<T,K>>& points, const std::size_t& begin, const std::size_t& end,
+                                 const std::size_t& depth, const Cell<T,K>& cell) const = 0;
+
+   // this method is the interface the kdtree builds a pcd file with, the points are rows begin through end
+   // whose coordinates lie dims apart in coordinates, by default the range is copied out into points so a
+   // strategy that only looks at points picks the same axis
+   virtual std::size_t splitAxis(const T* coordinates, const std::size_t& dims, const std::vector<std::uint32_t>& rows, const std::size_t& begin,
+                                 const std::size_t& end, const std::size_t& depth, const Cell<T,K>& cell) const {
+
+    std::vector<Point<T,K>> points(end - begin + 1, Point<T,K>(dims));
+
+    for (std::size_t i = begin; i <= end; i++) {
+     std::copy(coordinates + rows[i] * dims, coordinates + (rows[i] + 1) * dims, points[i - begin].begin());
+    }
+
+    return splitAxis(points, 0, end - begin, depth, cell);
+   }
+
+   virtual ~SplitAxisStrategy() {}
 
  }; // class SplitAxisStrategy
 } // namespace rossb83
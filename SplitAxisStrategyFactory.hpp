@@ -10,6 +10,8 @@
 #include "SplitAxisStrategy.hpp"
 #include "SplitAxisRoundRobinStrategy.hpp"
 #include "SplitAxisRangeStrategy.hpp"
+#include "SplitAxisVarianceStrategy.hpp"
+#include "SplitAxisCellStrategy.hpp"
 
 #include <unordered_map>
 #include <string>
@@ -20,19 +22,23 @@ namespace rossb83 {
 /*
  * class to create strategy to split axis based on input string decision
  */
-template <typename T>
+template <typename T, std::size_t K = 0>
 class SplitAxisStrategyFactory {
 
     public:
 
-	static std::shared_ptr<SplitAxisStrategy<T>> createSplitAxisStrategy(const std::string& strategy) {
+	static std::shared_ptr<SplitAxisStrategy<T,K>> createSplitAxisStrategy(const std::string& strategy) {
 
             if (strategy == "cycle") {
-                return std::make_shared<SplitAxisRoundRobinStrategy<T>>();
+                return std::make_shared<SplitAxisRoundRobinStrategy<T,K>>();
             } else if (strategy == "range") {
-                return std::make_shared<SplitAxisRangeStrategy<T>>();
+                return std::make_shared<SplitAxisRangeStrategy<T,K>>();
+            } else if (strategy == "variance") {
+                return std::make_shared<SplitAxisVarianceStrategy<T,K>>();
+            } else if (strategy == "cell") {
+                return std::make_shared<SplitAxisCellStrategy<T,K>>();
             } else {
-                return std::make_shared<SplitAxisRoundRobinStrategy<T>>();
+                return std::make_shared<SplitAxisRoundRobinStrategy<T,K>>();
             }
 	}
 
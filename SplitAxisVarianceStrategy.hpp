@@ -0,0 +1,109 @@
+#ifndef ROSSB83_SPLIT_AXIS_VARIANCE_STRATEGY_HPP
+#define ROSSB83_SPLIT_AXIS_VARIANCE_STRATEGY_HPP
+
+#include <vector>
+#include <iostream>
+
+#include "SplitAxisStrategy.hpp"
+
+namespace rossb83 {
+
+ // this split axis strategy will split the axis along which the points spread the most, measured
+ // by their variance, so cells stay close to cubes on data that is much wider along some axes
+ //
+ // the variance of every axis is summed in one pass over the points, each point's coordinates are
+ // contiguous so the pass reads every point once, nodes with more than sampleSize points are
+ // estimated from sampleSize evenly spaced points of their range, which picks the same axis
+ // unless two axes spread almost equally
+ //
+ // the axis depends on the order of the points in the range when sampling, so trees built with
+ // different split point strategies may differ, trees built with the same one never do
+ template<typename T, std::size_t K = 0>
+ class SplitAxisVarianceStrategy : public SplitAxisStrategy<T,K> {
+
+  public:
+
+   // default number of points the variance of a large node is estimated from
+   static constexpr std::size_t SAMPLE_SIZE = 1024;
+
+   // sampleSize 0 always uses every point
+   SplitAxisVarianceStrategy(const std::size_t& sampleSize = SAMPLE_SIZE) : sampleSize_(sampleSize) {}
+
+   // depth and cell are not needed, the variance is taken over the points themselves
+   std::size_t splitAxis(const std::vector<Point<T,K>>& points, const std::size_t& begin, const std::size_t& end,
+                         const std::size_t& depth, const Cell<T,K>& cell) const {
+
+    return widest(points[begin].dims(), begin, end, [&points](const std::size_t& i) {return points[i].data();});
+   }
+
+   std::size_t splitAxis(const T* coordinates, const std::size_t& dims, const std::vector<std::uint32_t>& rows, const std::size_t& begin,
+                         const std::size_t& end, const std::size_t& depth, const Cell<T,K>& cell) const {
+
+    return widest(dims, begin, end, [coordinates, &dims, &rows](const std::size_t& i) {return coordinates + rows[i] * dims;});
+   }
+
+  private:
+
+   // helper function to find the axis points begin through end spread the most along, point(i) reads the
+   // coordinates of the i-th point
+   template <typename Coordinates>
+   std::size_t widest(const std::size_t& dims, const std::size_t& begin, const std::size_t& end, Coordinates point) const {
+
+    // sums of the usual number of dimensions are kept on the stack so a node never allocates
+    static const std::size_t STACK_DIMS = 16;
+
+    const std::size_t count = end - begin + 1;
+    const std::size_t stride = (sampleSize_ > 0 && count > sampleSize_) ? (count + sampleSize_ - 1) / sampleSize_ : 1;
+
+    double stackSums[2 * STACK_DIMS] = {};
+    std::vector<double> heapSums((dims > STACK_DIMS) ? 2 * dims : 0, 0.0);
+
+    double* sums = (dims > STACK_DIMS) ? heapSums.data() : stackSums;
+    double* squares = sums + dims;
+
+    // sums are taken relative to the first point, which keeps their precision when the points lie
+    // far from the origin, the variance does not depend on the shift
+    const T* origin = point(begin);
+    std::size_t samples = 0;
+
+    for (std::size_t i = begin; i <= end; i += stride) {
+
+     const T* coordinates = point(i);
+
+     for (std::size_t axis = 0; axis < dims; axis++) {
+
+      double value = static_cast<double>(coordinates[axis]) - static_cast<double>(origin[axis]);
+      sums[axis] += value;
+      squares[axis] += value * value;
+     }
+
+     samples++;
+    }
+
+    // state variables to keep track of the largest spread and its axis, spreads are the variance
+    // times the number of samples, which is the same for every axis
+    std::size_t splitaxis = 0;
+    double maxspreadsofar = 0.0;
+
+    for (std::size_t axis = 0; axis < dims; axis++) {
+
+     double spread = squares[axis] - sums[axis] * sums[axis] / samples;
+
+     if (spread > maxspreadsofar) {
+
+      splitaxis = axis;
+      maxspreadsofar = spread;
+     }
+    }
+
+    return splitaxis;
+   }
+
+   // largest number of points the variance of a node is computed from, 0 for no limit
+   std::size_t sampleSize_;
+
+ };// class SplitAxisVarianceStrategy
+
+} // namespace rossb83
+
+#endif
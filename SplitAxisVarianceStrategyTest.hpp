@@ -0,0 +1,88 @@
+#ifndef ROSSB83_SPLIT_AXIS_VARIANCE_STRATEGY_TEST_HPP
+#define ROSSB83_SPLIT_AXIS_VARIANCE_STRATEGY_TEST_HPP
+
+#include <assert.h>
+
+#include "SplitAxisVarianceStrategy.hpp"
+#include "SplitAxisStrategyFactory.hpp"
+
+namespace rossb83 {
+
+ class SplitAxisVarianceStrategyTest {
+
+  public:
+
+   SplitAxisVarianceStrategyTest() {
+
+    std::cout << "Running SplitAxis Variance Strategy tests..." << std::endl;
+
+    varianceTest();
+    sampleTest();
+   }
+
+  private:
+
+   void varianceTest() {
+
+    std::cout << "split axis variance test..." << std::endl;
+    strategy = std::make_shared<SplitAxisVarianceStrategy<double>>();
+    Cell<double> cell(2);
+
+    // one outlier gives axis 0 the largest range while axis 1 spreads the most
+    std::vector<Point<double>> outlier = {{0,4},{0,-4},{0,4},{0,-4},{0,4},{0,-4},{0,4},{0,-4},{10,0}};
+
+    assert(strategy->splitAxis(outlier,0,8,0,cell) == 1);
+    assert(SplitAxisRangeStrategy<double>().splitAxis(outlier,0,8,0,cell) == 0);
+
+    // spreads below 1 still count
+    assert(strategy->splitAxis({{0.1,0.2},{0.2,0.9}},0,1,0,cell) == 1);
+
+    // points far from the origin keep their precision
+    assert(strategy->splitAxis({{1e9 + 0.01, 1e9},{1e9 + 0.02, 1e9 + 0.5},{1e9, 1e9 + 0.25}},0,2,0,cell) == 1);
+
+    // only the range begin through end is measured, a single point splits on axis 0
+    assert(strategy->splitAxis({{0,0},{5,1},{6,9},{100,0}},1,2,0,cell) == 1);
+    assert(strategy->splitAxis({{0,0},{5,1},{6,9}},2,2,0,cell) == 0);
+
+    // more dimensions than fit on the stack
+    Point<double> wide(20);
+    Point<double> wider(20);
+    wider[17] = 3.0;
+
+    assert(strategy->splitAxis({wide,wider},0,1,0,Cell<double>(20)) == 17);
+
+    assert(std::dynamic_pointer_cast<SplitAxisVarianceStrategy<double>>(SplitAxisStrategyFactory<double>::createSplitAxisStrategy("variance")));
+   }
+
+   void sampleTest() {
+
+    std::cout << "split axis variance sample test..." << std::endl;
+
+    // a node much larger than the sample, widest along axis 2
+    std::vector<Point<double>> points;
+
+    for (int i = 0; i < 10000; i++) {
+     points.push_back({double(i % 7), double((i * 31) % 50), double((i * 7919) % 1000)});
+    }
+
+    Cell<double> cell(3);
+
+    assert(SplitAxisVarianceStrategy<double>(0).splitAxis(points,0,9999,0,cell) == 2);
+    assert(SplitAxisVarianceStrategy<double>(16).splitAxis(points,0,9999,0,cell) == 2);
+    assert(SplitAxisVarianceStrategy<double>().splitAxis(points,0,9999,0,cell) == 2);
+
+    // seven points are sampled four at a time from every other one, so the odd points spread
+    // along axis 0 are never read
+    std::vector<Point<double>> strided = {{0,0},{100,1},{0,2},{-100,3},{0,4},{100,5},{0,6}};
+
+    assert(SplitAxisVarianceStrategy<double>(0).splitAxis(strided,0,6,0,cell) == 0);
+    assert(SplitAxisVarianceStrategy<double>(4).splitAxis(strided,0,6,0,cell) == 1);
+   }
+
+   std::shared_ptr<SplitAxisStrategy<double>> strategy;
+
+ }; // class SplitAxisVarianceStrategyTest
+
+} // namespace rossb83
+
+#endif // ROSSB83_SPLIT_AXIS_VARIANCE_STRATEGY_TEST_HPP
@@ -0,0 +1,38 @@
+#ifndef ROSSB83_SPLIT_POINT_PRESORT_STRATEGY
+#define ROSSB83_SPLIT_POINT_PRESORT_STRATEGY
+
+#include <algorithm>
+#include <cmath>
+
+#include "SplitPointStrategy.hpp"
+
+namespace rossb83 {
+
+ // this strategy determines which point the kdtree will make the next node, it works by sorting the
+ // indices of all points once per axis before the build, every node then reads its median straight off
+ // the order of its axis and splits the orders of the other axes in linear time, an O(kn log n) build
+ // rather than sorting every subrange at every node
+ //
+ // the kdtree runs this build itself, splitPoint only serves callers splitting a single range
+ template<typename T, std::size_t K = 0>
+ class SplitPointPresortStrategy : public SplitPointStrategy<T,K> {
+
+  public:
+   // this method will re-arrange the input placing the median between begin and end
+   Point<T,K> splitPoint(std::vector<Point<T,K>>& points, const std::size_t& dim, const std::size_t& begin, const std::size_t& end) {
+
+    auto mid = points.begin() + std::ceil((begin + end)/2.0);
+
+    std::nth_element(points.begin() + begin, mid, points.begin() + end + 1,
+    [dim](const Point<T,K>& p1, const Point<T,K>& p2) {return p1[dim] < p2[dim];});
+
+    return std::move(*mid);
+   }
+
+   bool presorted() const {return true;}
+
+ }; // class SplitPointPresortStrategy
+
+} // namespace rossb83
+
+#endif // ROSSB83_SPLIT_POINT_PRESORT_STRATEGY
@@ -0,0 +1,52 @@
+#ifndef ROSSB83_POINT_PRESORT_STRATEGY_TEST_HPP
+#define ROSSB83_POINT_PRESORT_STRATEGY_TEST_HPP
+
+#include <assert.h>
+#include "SplitPointStrategy.hpp"
+#include "SplitPointPresortStrategy.hpp"
+
+namespace rossb83 {
+
+ class SplitPointPresortStrategyTest {
+
+  public:
+
+   SplitPointPresortStrategyTest() {
+
+    std::cout << "Running Split Point Presort Strategy tests..." << std::endl;
+
+    presortTest();
+   }
+
+  private:
+
+   void presortTest() {
+
+    std::cout << "split point presort test..." << std::endl;
+    strategy = std::make_shared<SplitPointPresortStrategy<int>>();
+
+    // the kdtree builds from presorted orders instead of asking for every split point
+    assert(strategy->presorted());
+    assert(!SplitPointSortStrategy<int>().presorted());
+
+    std::vector<Point<int>> points;
+    points.push_back({7,2,8});
+    points.push_back({1,6,4});
+    points.push_back({9,8,0});
+    points.push_back({4,9,9});
+    points.push_back({5,0,1});
+
+    Point<int> p = strategy->splitPoint(points,0,0,4);
+    assert(p == Point<int>({5,0,1}));
+
+    p = strategy->splitPoint(points,1,0,1);
+    assert(p[1] == 6 || p[1] == 9);
+   }
+
+   std::shared_ptr<SplitPointStrategy<int>> strategy;
+
+ }; // class SplitPointPresortStrategyTest
+
+} // namespace rossb83
+
+#endif // ROSSB83_SPLIT_POINT_PRESORT_STRATEGY_TEST_HPP
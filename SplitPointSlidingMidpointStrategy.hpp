@@ -0,0 +1,103 @@
+#ifndef ROSSB83_SPLIT_POINT_SLIDING_MIDPOINT_STRATEGY
+#define ROSSB83_SPLIT_POINT_SLIDING_MIDPOINT_STRATEGY
+
+#include <algorithm>
+#include <type_traits>
+
+#include "SplitPointSelectStrategy.hpp"
+
+namespace rossb83 {
+
+ // this strategy determines which point the kdtree will make the next node, it works by cutting the
+ // cell of the node in half rather than its points, so on clustered data empty space is cut off in
+ // a few large cells instead of stretching thin cells from the clusters out across it
+ //
+ // the points are partitioned around the midpoint of the cell along the split axis and the lowest
+ // point above it becomes the split point, if every point lies on one side the split slides onto
+ // the nearest point, the cell of the emptied side shrinks onto the points so the following split
+ // cuts them again, pair it with the cell axis strategy so the longest side of the cell is the one
+ // cut, which keeps cells from getting much longer than wide
+ //
+ // the split point is not at the center of the range, so subtrees are not balanced and the tree is
+ // deeper than a median split, points that share their coordinate on the split axis can't be cut
+ // apart and are split on their median instead, and so is every node the kdtree builds past its
+ // depth limit, so skewed data can't make the tree as deep as it has points
+ template<typename T, std::size_t K = 0>
+ class SplitPointSlidingMidpointStrategy : public SplitPointSelectStrategy<T,K> {
+
+  public:
+   // this method will re-arrange the input so every point below the cell midpoint comes before the split point
+   std::size_t splitIndex(std::vector<Point<T,K>>& points, const std::size_t& dim, const std::size_t& begin, const std::size_t& end,
+                          const Cell<T,K>& cell) {
+
+    auto last = points.begin() + end + 1;
+    auto split = slide(points.begin() + begin, last, cut(cell, dim), [&dim](const Point<T,K>& p) {return p[dim];});
+
+    if (split == last) return this->medianIndex(points, dim, begin, end);
+
+    return split - points.begin();
+   }
+
+   // this method will re-arrange the rows of a pcd file so every row below the cell midpoint comes before the split point
+   std::size_t splitIndex(const T* coordinates, const std::size_t& dims, std::vector<std::uint32_t>& rows, const std::size_t& dim,
+                          const std::size_t& begin, const std::size_t& end, const Cell<T,K>& cell) {
+
+    auto last = rows.begin() + end + 1;
+    auto split = slide(rows.begin() + begin, last, cut(cell, dim), [coordinates, &dims, &dim](const std::uint32_t& r) {return coordinates[r * dims + dim];});
+
+    if (split == last) return this->medianIndex(coordinates, dims, rows, dim, begin, end);
+
+    return split - rows.begin();
+   }
+
+  private:
+   // helper function to find the midpoint of the cell along dim, integer coordinates are halved before they are added,
+   // with the remainders lost to halving added back, since the width of a wide cell overflows their type
+   static T cut(const Cell<T,K>& cell, const std::size_t& dim) {
+
+    const T& min = cell.min()[dim];
+    const T& max = cell.max()[dim];
+
+    if constexpr (std::is_integral<T>::value) {
+     return min / 2 + max / 2 + (min % 2 + max % 2) / 2;
+    } else {
+     return min + (max - min) / 2;
+    }
+   }
+
+   // helper function to split the points or rows first to last around cut, value reads the coordinate of one
+   // on the split axis, returns the split point or last when every one has the same value and can't be cut apart
+   template <typename Iterator, typename Value>
+   static Iterator slide(Iterator first, Iterator last, const T& cut, Value value) {
+
+    using std::swap;
+
+    auto less = [&value](const auto& e1, const auto& e2) {return value(e1) < value(e2);};
+
+    auto middle = std::partition(first, last, [&value, &cut](const auto& e) {return value(e) < cut;});
+
+    if (middle == last) {
+
+     // every point lies below the cut, slide down onto the highest one and leave the right side empty
+     auto highest = std::max_element(first, last, less);
+
+     if (value(*highest) == value(*std::min_element(first, last, less))) return last;
+
+     swap(*highest, *(last - 1));
+     return last - 1;
+    }
+
+    // the lowest point at or above the cut is the split point, with every point below the cut before it
+    auto lowest = std::min_element(middle, last, less);
+
+    if (middle == first && value(*lowest) == value(*std::max_element(first, last, less))) return last;
+
+    swap(*lowest, *middle);
+    return middle;
+   }
+
+ }; // class SplitPointSlidingMidpointStrategy
+
+} // namespace rossb83
+
+#endif // ROSSB83_SPLIT_POINT_SLIDING_MIDPOINT_STRATEGY
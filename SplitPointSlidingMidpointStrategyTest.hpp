@@ -0,0 +1,247 @@
+#ifndef ROSSB83_SPLIT_POINT_SLIDING_MIDPOINT_STRATEGY_TEST_HPP
+#define ROSSB83_SPLIT_POINT_SLIDING_MIDPOINT_STRATEGY_TEST_HPP
+
+#include <assert.h>
+#include <random>
+#include <iomanip>
+#include <limits>
+
+#include "SplitPointStrategy.hpp"
+#include "SplitPointSlidingMidpointStrategy.hpp"
+#include "SplitPointStrategyFactory.hpp"
+#include "SplitAxisStrategyFactory.hpp"
+#include "kdtree.hpp"
+#include "BinaryFileWriter.hpp"
+#include "PCDFile.hpp"
+
+namespace rossb83 {
+
+ class SplitPointSlidingMidpointStrategyTest {
+
+  public:
+
+   SplitPointSlidingMidpointStrategyTest() {
+
+    std::cout << "Running Split Point Sliding Midpoint Strategy tests..." << std::endl;
+
+    midpointTest();
+    slideTest();
+    kdtreeTest();
+    depthTest();
+   }
+
+  private:
+
+   // true iff no point before index lies above it on dim and no point after it lies below it
+   static bool splits(const std::vector<Point<double>>& points, const std::size_t& dim, const std::size_t& index) {
+
+    for (std::size_t i = 0; i < points.size(); i++) {
+
+     if (i < index && points[i][dim] > points[index][dim]) return false;
+     if (i > index && points[i][dim] < points[index][dim]) return false;
+    }
+
+    return true;
+   }
+
+   void midpointTest() {
+
+    std::cout << "split point sliding midpoint test..." << std::endl;
+    strategy = std::make_shared<SplitPointSlidingMidpointStrategy<double>>();
+
+    Cell<double> cell(2);
+    cell.min() = {0, 0};
+    cell.max() = {10, 10};
+
+    // the cut at 5 leaves four points below it, the lowest point above it is the split point
+    std::vector<Point<double>> points = {{9,0},{1,1},{6,2},{2,3},{3,4},{4,5},{8,6}};
+
+    std::size_t index = strategy->splitIndex(points,0,0,6,cell);
+
+    assert(index == 4);
+    assert(points[index][0] == 6);
+    assert(splits(points, 0, index));
+
+    // a sub range is split on its own, the points outside it stay put
+    std::vector<Point<double>> more = {{0,9},{0,1},{0,8},{0,2},{0,7}};
+
+    index = strategy->splitIndex(more,1,1,3,cell);
+
+    assert(index == 3 && more[3][1] == 8);
+    assert(more[0][1] == 9 && more[4][1] == 7);
+
+    // integer cells as wide as their type are cut at their midpoint rather than overflowing
+    SplitPointSlidingMidpointStrategy<int> integral;
+
+    Cell<int> wide(1);
+    wide.min() = {std::numeric_limits<int>::lowest()};
+    wide.max() = {std::numeric_limits<int>::max()};
+
+    std::vector<Point<int>> integers = {{std::numeric_limits<int>::max()},{-5},{3},{std::numeric_limits<int>::lowest()}};
+
+    index = integral.splitIndex(integers,0,0,3,wide);
+
+    assert(index == 2 && integers[2][0] == 3);
+
+    // remainders of odd negative bounds are added back, the cut at -2 splits -3 off
+    Cell<int> odd(1);
+    odd.min() = {-3};
+    odd.max() = {-1};
+
+    integers = {{-1},{-2},{-3}};
+
+    index = integral.splitIndex(integers,0,0,2,odd);
+
+    assert(index == 1 && integers[1][0] == -2);
+   }
+
+   void slideTest() {
+
+    std::cout << "split point sliding midpoint slide test..." << std::endl;
+
+    Cell<double> cell(2);
+    cell.min() = {0, 0};
+    cell.max() = {100, 100};
+
+    // every point below the cut, the split slides down onto the highest
+    std::vector<Point<double>> low = {{3,0},{1,0},{7,0},{2,0}};
+    std::size_t index = strategy->splitIndex(low,0,0,3,cell);
+
+    assert(index == 3 && low[3][0] == 7);
+    assert(splits(low, 0, index));
+
+    // every point above the cut, the split slides up onto the lowest
+    std::vector<Point<double>> high = {{90,0},{60,0},{99,0},{70,0}};
+    index = strategy->splitIndex(high,0,0,3,cell);
+
+    assert(index == 0 && high[0][0] == 60);
+    assert(splits(high, 0, index));
+
+    // points that can't be cut apart are split on their median
+    std::vector<Point<double>> same = {{4,0},{4,1},{4,2},{4,3},{4,4}};
+    index = strategy->splitIndex(same,0,0,4,cell);
+
+    assert(index == 2);
+
+    assert(std::dynamic_pointer_cast<SplitPointSlidingMidpointStrategy<double>>(SplitPointStrategyFactory<double>::createSplitPointStrategy("sliding")));
+   }
+
+   void kdtreeTest() {
+
+    std::cout << "split point sliding midpoint kdtree test..." << std::endl;
+
+    // dense clusters in a large empty space, with a few exact duplicates
+    std::mt19937_64 generator(7);
+    std::normal_distribution<double> cluster(0.0, 0.01);
+    std::uniform_real_distribution<double> uniform(0.0, 1000.0);
+
+    std::vector<Point<double>> centers(20, Point<double>(3));
+    for (Point<double>& center : centers) for (double& value : center) value = uniform(generator);
+
+    std::vector<Point<double>> points;
+
+    for (int i = 0; i < 20000; i++) {
+
+     Point<double> p(centers[i % centers.size()]);
+     if (i % 100 != 0) for (double& value : p) value += cluster(generator);
+     points.push_back(p);
+    }
+
+    auto sliding = SplitPointStrategyFactory<double>::createSplitPointStrategy("sliding");
+    auto select = SplitPointStrategyFactory<double>::createSplitPointStrategy("select");
+
+    for (std::string splitAxis : {"cycle", "range", "variance", "cell"}) {
+
+     auto splitAxisStrategy = SplitAxisStrategyFactory<double>::createSplitAxisStrategy(splitAxis);
+
+     KDTree<double> slidingKDTree(points.begin(), points.end(), sliding, splitAxisStrategy);
+     KDTree<double> parallelKDTree(points.begin(), points.end(), sliding, splitAxisStrategy, 4);
+     KDTree<double> bucketKDTree(points.begin(), points.end(), sliding, splitAxisStrategy, 1, 8);
+     KDTree<double> medianKDTree(points.begin(), points.end(), select, splitAxisStrategy);
+
+     // the tree does not depend on the number of threads
+     assert(slidingKDTree == parallelKDTree);
+     assert(slidingKDTree.points() == points.size());
+
+     // splits off the center still answer every query exactly
+     for (int i = 0; i < 300; i++) {
+
+      // half the queries land in a cluster and half in the empty space between them
+      Point<double> queryPoint(3);
+
+      for (std::size_t d = 0; d < 3; d++) {
+       queryPoint[d] = (i % 2) ? uniform(generator) : centers[i % centers.size()][d] + cluster(generator);
+      }
+
+      double distance = std::get<1>(medianKDTree.queryNearestNeighbor(queryPoint));
+
+      assert(std::get<1>(slidingKDTree.queryNearestNeighbor(queryPoint)) == distance);
+      assert(std::get<1>(bucketKDTree.queryNearestNeighbor(queryPoint)) == distance);
+      assert(std::get<1>(slidingKDTree.queryKNearest(queryPoint, 5)) == std::get<1>(medianKDTree.queryKNearest(queryPoint, 5)));
+     }
+    }
+
+    // unbalanced trees survive a round trip through a binary file
+    KDTree<double> slidingKDTree(points.begin(), points.begin() + 2000, sliding, SplitAxisStrategyFactory<double>::createSplitAxisStrategy("range"));
+
+    BinaryFileWriter<double>("sliding.kdt").writeFile(slidingKDTree);
+
+    {
+     BinaryFileReader<double> binaryfile("sliding.kdt");
+     KDTree<double> readKDTree(binaryfile);
+
+     assert(readKDTree == slidingKDTree);
+     assert(readKDTree.height() == slidingKDTree.height());
+    }
+
+    std::remove("sliding.kdt");
+   }
+
+   std::shared_ptr<SplitPointStrategy<double>> strategy;
+
+   void depthTest() {
+
+    std::cout << "split point sliding midpoint depth test..." << std::endl;
+
+    // every point lies twice as far out as the one before, so every midpoint cut only splits off the
+    // farthest point and without a depth limit the tree would be as deep as it has points
+    const std::size_t n = 1000;
+    std::vector<Point<double>> points;
+
+    for (std::size_t i = 0; i < n; i++) points.push_back({std::ldexp(1.0, static_cast<int>(i)), double(i % 7)});
+
+    {
+     std::ofstream skewed("skewed.csv");
+     skewed << std::setprecision(17);
+     for (const Point<double>& p : points) skewed << p[0] << "," << p[1] << '\n';
+    }
+
+    PCDFile<double> pcd("skewed.csv");
+    std::remove("skewed.csv");
+
+    auto sliding = SplitPointStrategyFactory<double>::createSplitPointStrategy("sliding");
+    auto cell = SplitAxisStrategyFactory<double>::createSplitAxisStrategy("cell");
+
+    KDTree<double> slidingKDTree(points.begin(), points.end(), sliding, cell);
+    KDTree<double> rowsKDTree(pcd, sliding, cell, 1);
+    KDTree<double> medianKDTree(points.begin(), points.end(), SplitPointStrategyFactory<double>::createSplitPointStrategy("select"), cell);
+
+    // 10 levels balance 1000 points, past 4 times that every node is split on its median
+    assert(slidingKDTree.height() > 10);
+    assert(slidingKDTree.height() <= 4 * 10 + 10 + 1);
+
+    // the rows of a pcd file fall back on the median at the same depth
+    assert(rowsKDTree == slidingKDTree);
+
+    for (std::size_t i = 0; i < n; i += 37) {
+
+     Point<double> queryPoint = {std::ldexp(1.5, static_cast<int>(i)), 3.0};
+     assert(std::get<1>(slidingKDTree.queryNearestNeighbor(queryPoint)) == std::get<1>(medianKDTree.queryNearestNeighbor(queryPoint)));
+    }
+   }
+
+ }; // class SplitPointSlidingMidpointStrategyTest
+
+} // namespace rossb83
+
+#endif // ROSSB83_SPLIT_POINT_SLIDING_MIDPOINT_STRATEGY_TEST_HPP
@@ -18,21 +18,40 @@ namespace rossb83 {
 
  // this strategy determines which point the kdtree will make the next node, it works by
  // sorting the input vector
- template<typename T>
- class SplitPointSortStrategy : public SplitPointStrategy<T> {
+ template<typename T, std::size_t K = 0>
+ class SplitPointSortStrategy : public SplitPointStrategy<T,K> {
 
   public:
    // this method will re-arrange the input by sorting it placing the median between begin and end
-   Point<T> splitPoint(std::vector<Point<T>>& points, const std::size_t& dim, const std::size_t& begin, const std::size_t& end) {
+   Point<T,K> splitPoint(std::vector<Point<T,K>>& points, const std::size_t& dim, const std::size_t& begin, const std::size_t& end) {
 
     // sort using the default operator<
     std::sort(points.begin() + begin, points.begin() + end + 1,
-    [dim](Point<T> p1, Point<T> p2) {return p1[dim] < p2[dim];});
+    [dim](const Point<T,K>& p1, const Point<T,K>& p2) {return p1[dim] < p2[dim];});
    
 
     return std::move(points[std::ceil((begin + end)/2.0)]);
    }
 
+   using SplitPointStrategy<T,K>::splitIndex;
+   using SplitPointStrategy<T,K>::medianIndex;
+
+   std::size_t splitIndex(const T* coordinates, const std::size_t& dims, std::vector<std::uint32_t>& rows, const std::size_t& dim,
+                          const std::size_t& begin, const std::size_t& end, const Cell<T,K>& cell) {
+
+    return medianIndex(coordinates, dims, rows, dim, begin, end);
+   }
+
+   // this method will re-arrange the rows of a pcd file by sorting them placing the median between begin and end
+   std::size_t medianIndex(const T* coordinates, const std::size_t& dims, std::vector<std::uint32_t>& rows, const std::size_t& dim,
+                           const std::size_t& begin, const std::size_t& end) {
+
+    std::sort(rows.begin() + begin, rows.begin() + end + 1,
+    [coordinates, &dims, &dim](const std::uint32_t& r1, const std::uint32_t& r2) {return coordinates[r1 * dims + dim] < coordinates[r2 * dims + dim];});
+
+    return std::ceil((begin + end)/2.0);
+   }
+
  }; // class SplitPointStrategy
 
 } // namespace rossb83
@@ -17,18 +17,90 @@
 #include <limits>
 #include <math.h>
 #include <complex>
+#include <cmath>
+#include <cstdint>
+
+#include "Cell.hpp"
 
 namespace rossb83 {
 
  // this abstract class is an interface to determine which point the kdtree will make the next node, it works by
- // finding the median in an input vector of points and placing that median point in the center of the vector
- template<typename T>
+ // finding the median in an input vector of points and placing that median point in the center of the vector,
+ // K is the compile time dimensionality of the points or 0 when chosen at runtime
+ template<typename T, std::size_t K = 0>
  class SplitPointStrategy {
 
   public:
    // this pure virtual method is an interface to the point selection strategy, it will re-arrange the input
    // point vector with the median placed at the center between begin and end
-   virtual Point<T> splitPoint(std::vector<Point<T>>& points, const std::size_t& dim, const std::size_t& begin, const std::size_t& end) = 0;
+   virtual Point<T,K> splitPoint(std::vector<Point<T,K>>& points, const std::size_t& dim, const std::size_t& begin, const std::size_t& end) = 0;
+
+   // this method is the interface the kdtree builds with, it re-arranges the input so that the split point sits
+   // at the returned index between begin and end, no point before it lies above it on dim and no point after it
+   // lies below it, cell is the space the node covers, by default the median is placed at the center
+   virtual std::size_t splitIndex(std::vector<Point<T,K>>& points, const std::size_t& dim, const std::size_t& begin, const std::size_t& end,
+                                  const Cell<T,K>& cell) {
+
+    return medianIndex(points, dim, begin, end);
+   }
+
+   // this method is the interface the kdtree builds a pcd file with, rows holds the indices of points whose
+   // coordinates lie dims apart in coordinates and is re-arranged the same way splitIndex re-arranges points,
+   // by default the range is copied out into points so a strategy that only splits points builds the same tree
+   virtual std::size_t splitIndex(const T* coordinates, const std::size_t& dims, std::vector<std::uint32_t>& rows, const std::size_t& dim,
+                                  const std::size_t& begin, const std::size_t& end, const Cell<T,K>& cell) {
+
+    return copied(coordinates, dims, rows, begin, end, [this, &dim, &cell](std::vector<Point<T,K>>& points, const std::size_t& last) {
+     return splitIndex(points, dim, 0, last, cell);
+    });
+   }
+
+   // this method places the median at the center between begin and end, the kdtree splits on it rather than on
+   // splitIndex once a strategy that doesn't split on the median has built a subtree too deep
+   std::size_t medianIndex(std::vector<Point<T,K>>& points, const std::size_t& dim, const std::size_t& begin, const std::size_t& end) {
+
+    std::size_t mid = std::ceil((begin + end)/2.0);
+    points[mid] = splitPoint(points, dim, begin, end);
+
+    return mid;
+   }
+
+   // this method places the median of the rows of a pcd file at the center, by default through copies of the rows
+   virtual std::size_t medianIndex(const T* coordinates, const std::size_t& dims, std::vector<std::uint32_t>& rows, const std::size_t& dim,
+                                   const std::size_t& begin, const std::size_t& end) {
+
+    return copied(coordinates, dims, rows, begin, end, [this, &dim](std::vector<Point<T,K>>& points, const std::size_t& last) {
+     return medianIndex(points, dim, 0, last);
+    });
+   }
+
+   // true when the kdtree should not call splitPoint at every node but split on the median of orders it
+   // presorts once per axis, see SplitPointPresortStrategy
+   virtual bool presorted() const {return false;}
+
+   virtual ~SplitPointStrategy() {}
+
+  private:
+   // helper function to re-arrange rows begin through end by splitting copies of them, split is handed the copies
+   // and the index of the last one, the center of the copies lies as far from their start as the center of the rows does
+   template <typename Split>
+   static std::size_t copied(const T* coordinates, const std::size_t& dims, std::vector<std::uint32_t>& rows, const std::size_t& begin,
+                             const std::size_t& end, Split split) {
+
+    std::vector<Point<T,K>> points(end - begin + 1, Point<T,K>(dims));
+
+    for (std::size_t i = begin; i <= end; i++) {
+
+     std::copy(coordinates + rows[i] * dims, coordinates + (rows[i] + 1) * dims, points[i - begin].begin());
+     points[i - begin].id(rows[i]);
+    }
+
+    std::size_t index = begin + split(points, end - begin);
+
+    for (std::size_t i = begin; i <= end; i++) rows[i] = points[i - begin].id();
+
+    return index;
+   }
 
  }; // class SplitPointStrategy
 } // namespace rossb83
@@ -10,6 +10,8 @@
 #include "SplitPointStrategy.hpp"
 #include "SplitPointSortStrategy.hpp"
 #include "SplitPointSelectStrategy.hpp"
+#include "SplitPointPresortStrategy.hpp"
+#include "SplitPointSlidingMidpointStrategy.hpp"
 
 #include <unordered_map>
 #include <string>
@@ -20,19 +22,23 @@ namespace rossb83 {
 /*
  * class to create strategy to split point at median based on input string decision
  */
-template <typename T>
+template <typename T, std::size_t K = 0>
 class SplitPointStrategyFactory {
 
     public:
 
-	static std::shared_ptr<SplitPointStrategy<T>> createSplitPointStrategy(const std::string& strategy) {
+	static std::shared_ptr<SplitPointStrategy<T,K>> createSplitPointStrategy(const std::string& strategy) {
 
             if (strategy == "sort") {
-                return std::make_shared<SplitPointSortStrategy<T>>();
+                return std::make_shared<SplitPointSortStrategy<T,K>>();
             } else if (strategy == "select") {
-                return std::make_shared<SplitPointSelectStrategy<T>>();
+                return std::make_shared<SplitPointSelectStrategy<T,K>>();
+            } else if (strategy == "presort") {
+                return std::make_shared<SplitPointPresortStrategy<T,K>>();
+            } else if (strategy == "sliding") {
+                return std::make_shared<SplitPointSlidingMidpointStrategy<T,K>>();
             } else {
-                return std::make_shared<SplitPointSortStrategy<T>>();
+                return std::make_shared<SplitPointSortStrategy<T,K>>();
             }
 	}
 
@@ -0,0 +1,239 @@
+#ifndef ROSSB83_THREAD_POOL_HPP
+#define ROSSB83_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <memory>
+
+// ben's namespace
+namespace rossb83 {
+
+/*
+ * fixed set of worker threads that run submitted tasks, each worker owns a deque of tasks
+ *
+ * a task submitted from a worker goes to the back of that worker's own deque and is picked up
+ * again from the back, so forked subtasks run depth first on the thread that forked them while
+ * idle workers steal the oldest tasks from the front of the other deques
+ *
+ * a thread waiting on a task with wait() runs pending tasks instead of blocking, which makes it
+ * safe for tasks to fork subtasks and wait on them
+ */
+class ThreadPool {
+
+    public:
+
+    /*
+     * starts the worker threads
+     * input threads - number of workers, 0 picks one per hardware thread
+     */
+    ThreadPool(const std::size_t& threads) : pending_(0), next_(0), stop_(false) {
+
+        std::size_t workers = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+
+        for (std::size_t i = 0; i < workers; i++) {
+            queues_.emplace_back(new TaskQueue());
+        }
+
+        for (std::size_t i = 0; i < workers; i++) {
+            workers_.emplace_back([this, i]() {run(i);});
+        }
+    }
+
+    // don't allow copying a thread pool, the workers belong to exactly one pool
+    ThreadPool(ThreadPool& other) = delete;
+
+    /*
+     * finishes every submitted task and joins the worker threads
+     */
+    ~ThreadPool() {
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+
+        condition_.notify_all();
+
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /*
+     * queues a task to run on a worker
+     * input task - callable taking no arguments
+     * output future holding the task's result, or the exception it threw
+     */
+    template <typename Task>
+    auto submit(Task task) -> std::future<decltype(task())> {
+
+        auto packagedTask = std::make_shared<std::packaged_task<decltype(task())()>>(std::move(task));
+        auto future = packagedTask->get_future();
+
+        // workers keep their own subtasks, other threads spread tasks over the workers
+        std::size_t index = (worker().first == this) ? worker().second : next_++ % queues_.size();
+
+        // counted before it is queued so the count never drops below the number of queued tasks
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_++;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queues_[index]->mutex_);
+            queues_[index]->tasks_.push_back([packagedTask]() {(*packagedTask)();});
+        }
+
+        condition_.notify_one();
+
+        return future;
+    }
+
+    /*
+     * waits for a task to finish, running other pending tasks in the meantime
+     * input future - future returned by submit
+     * output the task's result, rethrows the exception it threw
+     */
+    template <typename Result>
+    Result wait(std::future<Result>& future) {
+
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+
+            if (!runPendingTask()) std::this_thread::yield();
+        }
+
+        return future.get();
+    }
+
+    /*
+     * getter - number of worker threads
+     */
+    std::size_t threads() const {return workers_.size();}
+
+    private:
+
+    /*
+     * tasks owned by one worker
+     */
+    struct TaskQueue {
+
+        std::mutex mutex_;
+        std::deque<std::function<void()>> tasks_;
+    };
+
+    /*
+     * pool and worker index the calling thread belongs to, null pool for threads outside any pool
+     */
+    static std::pair<const ThreadPool*, std::size_t>& worker() {
+
+        thread_local std::pair<const ThreadPool*, std::size_t> current(nullptr, 0);
+        return current;
+    }
+
+    /*
+     * runs one pending task, newest from the calling worker's own deque or else oldest stolen from another deque
+     * output true iff a task was run
+     */
+    bool runPendingTask() {
+
+        std::function<void()> task;
+        bool own = (worker().first == this);
+        std::size_t index = own ? worker().second : 0;
+
+        if (own) {
+
+            std::lock_guard<std::mutex> lock(queues_[index]->mutex_);
+
+            if (!queues_[index]->tasks_.empty()) {
+
+                task = std::move(queues_[index]->tasks_.back());
+                queues_[index]->tasks_.pop_back();
+            }
+        }
+
+        for (std::size_t i = 0; !task && i < queues_.size(); i++) {
+
+            TaskQueue& victim = *queues_[(index + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex_);
+
+            if (!victim.tasks_.empty()) {
+
+                task = std::move(victim.tasks_.front());
+                victim.tasks_.pop_front();
+            }
+        }
+
+        if (!task) return false;
+
+        pending_--;
+        task();
+
+        return true;
+    }
+
+    /*
+     * worker loop, runs tasks until the pool is stopped and no task is left
+     */
+    void run(const std::size_t& index) {
+
+        worker() = std::make_pair(this, index);
+
+        while (true) {
+
+            if (runPendingTask()) continue;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() {return stop_ || pending_ > 0;});
+
+            if (stop_ && pending_ == 0) return;
+        }
+    }
+
+    /*
+     * worker threads
+     */
+    std::vector<std::thread> workers_;
+
+    /*
+     * task deque of every worker
+     */
+    std::vector<std::unique_ptr<TaskQueue>> queues_;
+
+    /*
+     * number of tasks submitted and not yet started
+     */
+    std::atomic<std::size_t> pending_;
+
+    /*
+     * worker to hand the next task submitted from outside the pool to
+     */
+    std::atomic<std::size_t> next_;
+
+    /*
+     * guards sleeping and waking workers
+     */
+    std::mutex mutex_;
+
+    /*
+     * wakes workers when a task is queued or the pool stops
+     */
+    std::condition_variable condition_;
+
+    /*
+     * set when the pool is destroyed
+     */
+    bool stop_;
+
+}; // class ThreadPool
+
+} // namespace rossb83
+
+#endif // ROSSB83_THREAD_POOL_HPP
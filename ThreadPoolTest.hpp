@@ -0,0 +1,104 @@
+#ifndef ROSSB83_THREAD_POOL_TEST_HPP
+#define ROSSB83_THREAD_POOL_TEST_HPP
+
+#include <assert.h>
+#include <atomic>
+#include <stdexcept>
+
+#include "ThreadPool.hpp"
+
+namespace rossb83 {
+
+ class ThreadPoolTest {
+
+  public:
+
+   ThreadPoolTest() {
+
+    std::cout << "Running ThreadPool tests..." << std::endl;
+
+    createTest();
+    submitTest();
+    exceptionTest();
+    forkJoinTest();
+   }
+
+  private:
+
+   void createTest() {
+
+    std::cout << "ThreadPool create test..." << std::endl;
+
+    ThreadPool pool(3);
+    assert(pool.threads() == 3);
+
+    ThreadPool defaultPool(0);
+    assert(defaultPool.threads() > 0);
+   }
+
+   void submitTest() {
+
+    std::cout << "ThreadPool submit test..." << std::endl;
+
+    std::atomic<int> counter(0);
+    std::vector<std::future<int>> futures;
+
+    {
+     ThreadPool pool(4);
+
+     for (int i = 0; i < 100; i++) {
+      futures.push_back(pool.submit([i, &counter]() {counter++; return i * i;}));
+     }
+
+     for (int i = 0; i < 100; i++) {
+      assert(futures[i].get() == i * i);
+     }
+    }
+
+    assert(counter == 100);
+   }
+
+   void exceptionTest() {
+
+    std::cout << "ThreadPool exception test..." << std::endl;
+
+    ThreadPool pool(2);
+    std::future<int> future = pool.submit([]() -> int {throw std::runtime_error("task failed");});
+
+    bool thrown = false;
+
+    try {
+     future.get();
+    } catch (const std::runtime_error& e) {
+     thrown = true;
+    }
+
+    assert(thrown);
+   }
+
+   void forkJoinTest() {
+
+    std::cout << "ThreadPool fork join test..." << std::endl;
+
+    // every task forks two subtasks and waits on them, more waiting tasks than workers must not deadlock
+    ThreadPool pool(2);
+
+    std::function<int(int)> fib = [&pool, &fib](int n) -> int {
+
+     if (n < 2) return n;
+
+     std::future<int> left = pool.submit([&fib, n]() {return fib(n - 1);});
+     int right = fib(n - 2);
+
+     return pool.wait(left) + right;
+    };
+
+    std::future<int> result = pool.submit([&fib]() {return fib(15);});
+    assert(pool.wait(result) == 610);
+   }
+
+ }; // class ThreadPoolTest
+
+} // namespace rossb83
+
+#endif // ROSSB83_THREAD_POOL_TEST_HPP
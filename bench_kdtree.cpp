@@ -0,0 +1,259 @@
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <cstdio>
+
+#include "Point.hpp"
+#include "kdtree.hpp"
+#include "DotFileWriter.hpp"
+#include "DotFileReader.hpp"
+#include "BinaryFileWriter.hpp"
+#include "BinaryFileReader.hpp"
+#include "PCDFile.hpp"
+#include "SplitAxisStrategyFactory.hpp"
+#include "SplitPointStrategyFactory.hpp"
+
+#include <string>
+
+using namespace rossb83;
+
+/*
+ * helper function to time a function, the fastest of repeat runs is reported since it is the
+ * run least disturbed by the rest of the machine
+ */
+template <typename Function>
+double seconds(const std::size_t& repeat, Function function) {
+
+    double fastest = std::numeric_limits<double>::max();
+
+    for (std::size_t i = 0; i < std::max<std::size_t>(repeat, 1); i++) {
+
+        auto start = std::chrono::steady_clock::now();
+        function();
+        fastest = std::min(fastest, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return fastest;
+}
+
+/*
+ * helper function to read a percentile out of sorted samples
+ */
+double percentile(const std::vector<double>& sorted, const double& p) {
+
+    if (sorted.empty()) return 0.0;
+
+    return sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(p * sorted.size()))];
+}
+
+/*
+ * helper function to get the size of a file in megabytes
+ */
+double megabytes(const std::string& filename) {
+
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    return static_cast<double>(file.tellg()) / (1024.0 * 1024.0);
+}
+
+/*
+ * microbenchmarks of building, querying and reading/writing kdtrees on a seeded random point
+ * cloud, results are written as json so runs can be compared to catch regressions
+ */
+int main(int argc, char* argv[]) {
+
+    static const std::string OUTPUT_FILE = "outputfile";
+    static const std::string POINTS = "points";
+    static const std::string QUERIES = "queries";
+    static const std::string DIMS = "dims";
+    static const std::string SEED = "seed";
+    static const std::string REPEAT = "repeat";
+    static const std::string THREADS = "threads";
+    static const std::string BRUTE_FORCE = "bruteforce";
+
+    std::unordered_map<std::string,std::string> inputs;
+    inputs.insert({{OUTPUT_FILE,"bench_kdtree.json"},{POINTS,"100000"},{QUERIES,"10000"},{DIMS,"3"},{SEED,"1"},{REPEAT,"3"},{THREADS,"1"},{BRUTE_FORCE,"200"}});
+
+    for (size_t i = 1; i < argc; i++) {
+
+        std::string input = std::string(argv[i]);
+        int delimiter = input.find("=");
+
+        if ((argv[i][0] == '-') && (delimiter != std::string::npos)) {
+
+            inputs[input.substr(1,delimiter-1)] = input.substr(delimiter+1);
+        }
+    }
+
+    std::size_t points = std::stoul(inputs[POINTS]);
+    std::size_t queries = std::stoul(inputs[QUERIES]);
+    std::size_t dims = std::stoul(inputs[DIMS]);
+    std::size_t repeat = std::stoul(inputs[REPEAT]);
+    std::size_t threads = std::stoul(inputs[THREADS]);
+    std::size_t bruteForce = std::min(std::stoul(inputs[BRUTE_FORCE]), queries);
+
+    // the same seed always generates the same points, uniform in the unit cube
+    std::mt19937_64 generator(std::stoull(inputs[SEED]));
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    auto generate = [&generator, &uniform, &dims](const std::size_t& count) {
+
+        std::vector<Point<double>> generated(count, Point<double>(dims));
+
+        for (Point<double>& p : generated) {
+            for (double& value : p) value = uniform(generator);
+        }
+
+        return generated;
+    };
+
+    std::vector<Point<double>> samplePoints = generate(points);
+    std::vector<Point<double>> queryPoints = generate(queries);
+
+    std::ofstream out(inputs[OUTPUT_FILE]);
+    out << std::setprecision(9);
+
+    out << "{\n";
+    out << "  \"config\": {\"points\": " << points << ", \"queries\": " << queries << ", \"dims\": " << dims << ", \"seed\": " << inputs[SEED]
+        << ", \"repeat\": " << repeat << ", \"threads\": " << threads << "},\n";
+
+    // build time of every strategy combination
+    std::cout << "Benchmarking builds of " << points << " points" << std::endl;
+
+    out << "  \"build\": [\n";
+
+    bool first = true;
+
+    for (std::string splitPoint : {"sort", "select", "presort", "sliding"}) {
+
+        for (std::string splitAxis : {"cycle", "range", "variance", "cell"}) {
+
+            auto splitPointStrategy = SplitPointStrategyFactory<double>::createSplitPointStrategy(splitPoint);
+            auto splitAxisStrategy = SplitAxisStrategyFactory<double>::createSplitAxisStrategy(splitAxis);
+            std::size_t height = 0;
+
+            double t = seconds(repeat, [&]() {
+                KDTree<double> kdtree(samplePoints.begin(), samplePoints.end(), splitPointStrategy, splitAxisStrategy, threads);
+                height = kdtree.height();
+            });
+
+            std::cout << "\t" << splitPoint << "/" << splitAxis << ": " << t << "s" << std::endl;
+
+            out << (first ? "" : ",\n") << "    {\"splitpoint\": \"" << splitPoint << "\", \"splitaxis\": \"" << splitAxis << "\", \"seconds\": " << t
+                << ", \"points_per_second\": " << points / t << ", \"height\": " << height << "}";
+
+            first = false;
+        }
+    }
+
+    out << "\n  ],\n";
+
+    // latency of single queries through a reused context and throughput of batch queries
+    std::cout << "Benchmarking " << queries << " nearest neighbor queries" << std::endl;
+
+    KDTree<double> kdtree(samplePoints.begin(), samplePoints.end(),
+        SplitPointStrategyFactory<double>::createSplitPointStrategy("select"), SplitAxisStrategyFactory<double>::createSplitAxisStrategy("cycle"));
+
+    KDTree<double>::QueryContext context(kdtree);
+    std::vector<double> latencies(queries);
+    double checksum = 0.0;
+
+    double total = seconds(repeat, [&]() {
+
+        for (std::size_t i = 0; i < queries; i++) {
+
+            auto start = std::chrono::steady_clock::now();
+            checksum += kdtree.queryNearestNeighbor(queryPoints[i], context).second;
+            latencies[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        }
+    });
+
+    std::sort(latencies.begin(), latencies.end());
+
+    double batch = seconds(repeat, [&]() {kdtree.queryNearestNeighbor(queryPoints, threads);});
+
+    out << "  \"query\": {\"p50_us\": " << percentile(latencies, 0.5) << ", \"p90_us\": " << percentile(latencies, 0.9)
+        << ", \"p99_us\": " << percentile(latencies, 0.99) << ", \"max_us\": " << latencies.back()
+        << ", \"queries_per_second\": " << queries / total << ", \"batch_queries_per_second\": " << queries / batch << "},\n";
+
+    std::cout << "\tp50: " << percentile(latencies, 0.5) << "us p99: " << percentile(latencies, 0.99) << "us" << std::endl;
+
+    // the tree against scanning every point of a pointcloud
+    std::cout << "Benchmarking brute force on " << bruteForce << " queries" << std::endl;
+
+    PointCloud<double> pointCloud(points, dims);
+
+    for (const Point<double>& p : samplePoints) {
+        pointCloud.addPoint(p);
+    }
+
+    double scan = seconds(repeat, [&]() {
+        for (std::size_t i = 0; i < bruteForce; i++) checksum += std::get<1>(pointCloud.queryNearestNeighbor(queryPoints[i]));
+    });
+
+    double search = seconds(repeat, [&]() {
+        for (std::size_t i = 0; i < bruteForce; i++) checksum += kdtree.queryNearestNeighbor(queryPoints[i], context).second;
+    });
+
+    out << "  \"bruteforce\": {\"queries\": " << bruteForce << ", \"pointcloud_us\": " << 1e6 * scan / std::max<std::size_t>(bruteForce, 1)
+        << ", \"kdtree_us\": " << 1e6 * search / std::max<std::size_t>(bruteForce, 1) << ", \"speedup\": " << scan / search << "},\n";
+
+    std::cout << "\tspeedup: " << scan / search << std::endl;
+
+    // parse and write throughput of every file format, files are removed afterwards
+    std::cout << "Benchmarking file formats" << std::endl;
+
+    const std::string pcdFilename = "bench_kdtree.csv";
+    const std::string dotFilename = "bench_kdtree.dot";
+    const std::string binaryFilename = "bench_kdtree.kdt";
+
+    {
+        std::ofstream pcd(pcdFilename);
+        pcd << std::setprecision(17);
+
+        for (const Point<double>& p : samplePoints) {
+
+            for (std::size_t i = 0; i < dims; i++) pcd << ((i > 0) ? "," : "") << p[i];
+            pcd << '\n';
+        }
+    }
+
+    double pcdRead = seconds(repeat, [&]() {PCDFile<double> pcd(pcdFilename);});
+    double dotWrite = seconds(repeat, [&]() {DotFileWriter<double>(dotFilename).writeFile(kdtree);});
+
+    double dotRead = seconds(repeat, [&]() {
+        DotFileReader<double> dotfile(dotFilename);
+        KDTree<double> read(dotfile);
+    });
+
+    double binaryWrite = seconds(repeat, [&]() {BinaryFileWriter<double>(binaryFilename).writeFile(kdtree);});
+
+    double binaryRead = seconds(repeat, [&]() {
+        BinaryFileReader<double> binaryfile(binaryFilename);
+        KDTree<double> read(binaryfile);
+    });
+
+    auto format = [&out, &points](const std::string& name, const std::string& filename, const double& t, const bool& last) {
+        out << "    \"" << name << "\": {\"seconds\": " << t << ", \"mb_per_second\": " << megabytes(filename) / t
+            << ", \"points_per_second\": " << points / t << "}" << (last ? "\n" : ",\n");
+    };
+
+    out << "  \"io\": {\n";
+    format("pcd_read", pcdFilename, pcdRead, false);
+    format("dot_write", dotFilename, dotWrite, false);
+    format("dot_read", dotFilename, dotRead, false);
+    format("binary_write", binaryFilename, binaryWrite, false);
+    format("binary_read", binaryFilename, binaryRead, true);
+    out << "  },\n";
+
+    std::remove(pcdFilename.c_str());
+    std::remove(dotFilename.c_str());
+    std::remove(binaryFilename.c_str());
+
+    // printed so the queries can't be optimized away
+    out << "  \"checksum\": " << checksum << "\n";
+    out << "}\n";
+
+    std::cout << "Results written to: " << inputs[OUTPUT_FILE] << std::endl;
+
+    return 0;
+}
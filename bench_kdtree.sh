@@ -0,0 +1,14 @@
+#!/bin/sh
+
+# this will benchmark building, querying and reading/writing kdtrees on a random point cloud and store the results as json
+# allocations and peak bytes are measured by bench_memory, counting them here would slow every timed allocation
+# -outputfile=bench_kdtree.json output file to store results
+# -points=100000 number of points to build kdtrees of
+# -queries=10000 number of nearest neighbor queries to time
+# -dims=3 dimensionality of the points
+# -seed=1 seed of the random points, the same seed always benchmarks the same points
+# -repeat=3 number of runs of every benchmark, the fastest run is reported
+# -threads=1 number of worker threads to build and batch query with, 0 uses every hardware thread
+# -bruteforce=200 number of queries to compare against scanning every point of a pointcloud
+
+./bench_kdtree -outputfile=bench_kdtree.json -points=100000 -queries=10000
@@ -0,0 +1,136 @@
+#include <random>
+#include <iomanip>
+#include <cstdio>
+
+// count every allocation so each phase can report what it allocated, this replaces operator new for
+// the whole binary which is why these phases are not part of bench_kdtree's timings
+#define ROSSB83_COUNT_ALLOCATIONS
+#include "AllocationCounter.hpp"
+
+#include "Point.hpp"
+#include "kdtree.hpp"
+#include "BinaryFileWriter.hpp"
+#include "PCDFile.hpp"
+
+#include <string>
+
+using namespace rossb83;
+
+/*
+ * allocations and peak memory of every phase of reading a seeded random point cloud into a
+ * kdtree, writing it and querying it, results are written as json so runs can be compared
+ */
+int main(int argc, char* argv[]) {
+
+    static const std::string OUTPUT_FILE = "outputfile";
+    static const std::string POINTS = "points";
+    static const std::string QUERIES = "queries";
+    static const std::string DIMS = "dims";
+    static const std::string SEED = "seed";
+    static const std::string THREADS = "threads";
+
+    std::unordered_map<std::string,std::string> inputs;
+    inputs.insert({{OUTPUT_FILE,"bench_memory.json"},{POINTS,"100000"},{QUERIES,"10000"},{DIMS,"3"},{SEED,"1"},{THREADS,"1"}});
+
+    for (size_t i = 1; i < argc; i++) {
+
+        std::string input = std::string(argv[i]);
+        int delimiter = input.find("=");
+
+        if ((argv[i][0] == '-') && (delimiter != std::string::npos)) {
+
+            inputs[input.substr(1,delimiter-1)] = input.substr(delimiter+1);
+        }
+    }
+
+    std::size_t points = std::stoul(inputs[POINTS]);
+    std::size_t queries = std::stoul(inputs[QUERIES]);
+    std::size_t dims = std::stoul(inputs[DIMS]);
+    std::size_t threads = std::stoul(inputs[THREADS]);
+
+    // the same seed always generates the same points as bench_kdtree, uniform in the unit cube
+    std::mt19937_64 generator(std::stoull(inputs[SEED]));
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    auto generate = [&generator, &uniform, &dims](const std::size_t& count) {
+
+        std::vector<Point<double>> generated(count, Point<double>(dims));
+
+        for (Point<double>& p : generated) {
+            for (double& value : p) value = uniform(generator);
+        }
+
+        return generated;
+    };
+
+    std::vector<Point<double>> samplePoints = generate(points);
+    std::vector<Point<double>> queryPoints = generate(queries);
+
+    const std::string pcdFilename = "bench_memory.csv";
+    const std::string binaryFilename = "bench_memory.kdt";
+
+    {
+        std::ofstream pcd(pcdFilename);
+        pcd << std::setprecision(17);
+
+        for (const Point<double>& p : samplePoints) {
+
+            for (std::size_t i = 0; i < dims; i++) pcd << ((i > 0) ? "," : "") << p[i];
+            pcd << '\n';
+        }
+    }
+
+    std::cout << "Measuring memory of " << points << " points" << std::endl;
+
+    std::vector<AllocationPhase::Report> reports;
+    std::size_t kdtreeBytes = 0;
+
+    {
+        AllocationPhase parse("parse");
+        PCDFile<double> pcd(pcdFilename);
+        reports.push_back(parse.report());
+
+        AllocationPhase insert("cloud_insert");
+        PointCloud<double> cloud(pcd);
+        reports.push_back(insert.report());
+
+        AllocationPhase build("build");
+        KDTree<double> kdtree(pcd);
+        reports.push_back(build.report());
+
+        AllocationPhase serialize("serialize");
+        BinaryFileWriter<double>(binaryFilename).writeFile(kdtree);
+        reports.push_back(serialize.report());
+
+        AllocationPhase query("query_batch");
+        kdtree.queryNearestNeighbor(queryPoints, threads);
+        reports.push_back(query.report());
+
+        kdtreeBytes = kdtree.memoryUsage();
+    }
+
+    std::remove(pcdFilename.c_str());
+    std::remove(binaryFilename.c_str());
+
+    std::ofstream out(inputs[OUTPUT_FILE]);
+    out << std::setprecision(9);
+
+    out << "{\n";
+    out << "  \"config\": {\"points\": " << points << ", \"queries\": " << queries << ", \"dims\": " << dims << ", \"seed\": " << inputs[SEED]
+        << ", \"threads\": " << threads << "},\n";
+    out << "  \"kdtree_bytes\": " << kdtreeBytes << ",\n  \"bytes_per_point\": " << static_cast<double>(kdtreeBytes) / points << ",\n  \"phases\": [\n";
+
+    for (std::size_t i = 0; i < reports.size(); i++) {
+
+        out << "    {\"phase\": \"" << reports[i].name_ << "\", \"allocations\": " << reports[i].allocations_ << ", \"bytes\": " << reports[i].bytes_
+            << ", \"peak_bytes\": " << reports[i].peakBytes_ << ", \"resident_peak_bytes\": " << reports[i].residentPeak_ << "}"
+            << ((i + 1 < reports.size()) ? ",\n" : "\n");
+    }
+
+    out << "  ]\n}\n";
+
+    std::cout << "\tbytes per point: " << static_cast<double>(kdtreeBytes) / points << std::endl;
+    std::cout << "Results written to: " << inputs[OUTPUT_FILE] << std::endl;
+
+    return 0;
+}
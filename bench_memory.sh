@@ -0,0 +1,12 @@
+#!/bin/sh
+
+# this will measure the allocations and peak bytes of parsing, inserting, building, serializing and batch querying a random point cloud and store the results as json
+# allocations are counted by replacing operator new, so this is a separate binary from bench_kdtree whose timings must not pay for counting
+# -outputfile=bench_memory.json output file to store results
+# -points=100000 number of points to build a kdtree of
+# -queries=10000 number of nearest neighbor queries in the batch
+# -dims=3 dimensionality of the points
+# -seed=1 seed of the random points, the same seed measures the same points as bench_kdtree
+# -threads=1 number of worker threads to batch query with, 0 uses every hardware thread
+
+./bench_memory -outputfile=bench_memory.json -points=100000
@@ -3,6 +3,7 @@
 #include "Point.hpp"
 #include "kdtree.hpp"
 #include "DotFileWriter.hpp"
+#include "BinaryFileWriter.hpp"
 #include "PCDFile.hpp"
 #include "SplitAxisStrategyFactory.hpp"
 #include "SplitPointStrategyFactory.hpp"
@@ -20,9 +21,15 @@ int main(int argc, char* argv[]) {
     static const std::string OUTPUT_FILE = "outputfile";
     static const std::string SPLIT_POINT = "splitpoint";
     static const std::string SPLIT_AXIS = "splitaxis";
+    static const std::string THREADS = "threads";
+    static const std::string FORMAT = "format";
+    static const std::string BUCKET_SIZE = "bucketsize";
+    static const std::string DEDUPLICATE = "dedup";
+    static const std::string TIMINGS_FILE = "timings";
+    static const std::string PROGRESS = "progress";
 
     std::unordered_map<std::string,std::string> inputs;
-    inputs.insert({{INPUT_FILE,"sample_data.csv"},{OUTPUT_FILE,"sample_kdtree.dot"},{SPLIT_POINT,"sort"},{SPLIT_AXIS,"cycle"}});
+    inputs.insert({{INPUT_FILE,"sample_data.csv"},{OUTPUT_FILE,"sample_kdtree.dot"},{SPLIT_POINT,"sort"},{SPLIT_AXIS,""},{THREADS,"1"},{FORMAT,"dot"},{BUCKET_SIZE,"1"},{DEDUPLICATE,"0"},{TIMINGS_FILE,""},{PROGRESS,"10"}});
 
     for (size_t i = 1; i < argc; i++) {
 
@@ -35,27 +42,59 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // sliding midpoint is meant to cut the longest side of the cell, every other strategy cycles through the axes unless told otherwise
+    if (inputs[SPLIT_AXIS].empty()) inputs[SPLIT_AXIS] = (inputs[SPLIT_POINT] == "sliding") ? "cell" : "cycle";
+
+    // every phase is timed and long phases report their progress on stderr, apart from the regular output
+    BuildMonitor monitor(std::cerr, std::stod(inputs[PROGRESS]));
+
     std::cout << "Reading point data input file: " << inputs[INPUT_FILE] << std::endl;
 
-    // read input file from disk
+    // read input file from disk, the file is scanned and parsed in one pass
+    monitor.begin("parse");
     PCDFile<double> inputfile(inputs[INPUT_FILE]);
+    monitor.end(inputfile.points());
 
     std::cout << "Building kdtree with: " << std::endl;
     std::cout << "\tSplit Axis Strategy: " << inputs[SPLIT_AXIS] << std::endl;
     std::cout << "\tSplit Point Strategy: " << inputs[SPLIT_POINT] << std::endl;
+    std::cout << "\tThreads: " << inputs[THREADS] << std::endl;
+    std::cout << "\tBucket Size: " << inputs[BUCKET_SIZE] << std::endl;
+    std::cout << "\tRemove Duplicates: " << inputs[DEDUPLICATE] << std::endl;
 
     // generate strategies to create kdtree
     std::shared_ptr<SplitAxisStrategy<double>> splitAxisStrategy = SplitAxisStrategyFactory<double>::createSplitAxisStrategy(inputs[SPLIT_AXIS]);
     std::shared_ptr<SplitPointStrategy<double>> splitPointStrategy = SplitPointStrategyFactory<double>::createSplitPointStrategy(inputs[SPLIT_POINT]);
 
     // generate kdtree from input file
-    KDTree<double> kdtree(inputfile, splitPointStrategy, splitAxisStrategy);
+    KDTree<double> kdtree(inputfile, splitPointStrategy, splitAxisStrategy, std::stoul(inputs[THREADS]), std::stoul(inputs[BUCKET_SIZE]),
+        inputs[DEDUPLICATE] == "1", &monitor);
+
+    std::cout << "Serializing kdtree to " << inputs[FORMAT] << " output file: " << inputs[OUTPUT_FILE] << std::endl;
+
+    monitor.begin("serialize", kdtree.points());
 
-    std::cout << "Serializing kdtree to output file: " << inputs[OUTPUT_FILE] << std::endl;
-    
     // serialize kdtree and store on disk
-    DotFileWriter<double> dotfile(inputs[OUTPUT_FILE]);
-    dotfile.writeFile(kdtree);
+    if (inputs[FORMAT] == "binary") {
+
+        BinaryFileWriter<double> binaryfile(inputs[OUTPUT_FILE]);
+        binaryfile.writeFile(kdtree);
+
+    } else {
+
+        DotFileWriter<double> dotfile(inputs[OUTPUT_FILE]);
+        dotfile.writeFile(kdtree);
+    }
+
+    monitor.end();
+
+    std::cerr << "total: " << monitor.seconds() << "s, " << inputfile.points() / monitor.seconds() << " points per second" << std::endl;
+
+    if (!inputs[TIMINGS_FILE].empty()) {
+
+        std::cout << "Writing build timings file: " << inputs[TIMINGS_FILE] << std::endl;
+        monitor.writeFile(inputs[TIMINGS_FILE], inputfile.points());
+    }
 
     return 0;
 }
@@ -3,8 +3,14 @@
 # this will build a kdtree from an input point cloud file
 # -inputfile=sample_data.csv input pointcloud file
 # -outputfile=sample_kdtree.dot ouptut serialized kdtree
-# -splitpoint=select choose split point strategy, choices are either "select" or "sort"
-# -splitaxis=cycle choose split axis strategy, choices are either "cycle" or "range"
+# -splitpoint=select choose split point strategy, choices are "select", "sort" or "presort" (sorts once per axis up front, fastest on large clouds) or "sliding" (cuts the cell in half instead of the points, best on clustered data, splits -splitaxis=cell unless told otherwise)
+# -splitaxis=cycle choose split axis strategy, choices are "cycle", "range", "variance" (axis the points spread the most along, best on data much wider along some axes) or "cell" (longest side of the cell, meant for -splitpoint=sliding)
+# -threads=1 number of worker threads to build with, 0 uses every hardware thread, the tree does not depend on it
+# -format=dot output format, choices are either "dot" (graphviz text) or "binary" (compact file queried in place)
+# -bucketsize=1 largest number of points per leaf, larger buckets make a smaller tree that is faster to query, only binary output can hold buckets
+# -dedup=0 set to 1 to keep only the first of the points sharing the same coordinates
+# -timings= optional json file to store the seconds and throughput of every build phase, the phases are always logged on stderr
+# -progress=10 least seconds between two progress lines of a long phase on stderr
 
 #./build_kdtree -inputfile=sample_data.csv -outputfile=sample_kdtree.dot -splitpoint=select -splitaxis=range
 
@@ -23,147 +23,1603 @@
 #include <complex>
 #include <cmath>
 #include <typeinfo>
+#include <cstdint>
+#include <atomic>
 
 #include "PointCloud.hpp"
+#include "Cell.hpp"
 #include "SplitPointSortStrategy.hpp"
 #include "SplitAxisRoundRobinStrategy.hpp"
 #include "DotFileReader.hpp"
+#include "BinaryFileReader.hpp"
+#include "ThreadPool.hpp"
+#include "DistanceKernel.hpp"
+#include "QueryStats.hpp"
+#include "BuildMonitor.hpp"
 
 // ben's namespace
 namespace rossb83 {
 
+template <typename T>
+class BinaryFileWriter;
+
 /*
  * datastructure that stores k-dimensional points and allows fast query of nearest neighbors
+ *
+ * nodes are kept in one contiguous array and refer to their children by index, the coordinates
+ * of point i are stored densely at coordinates_[i*dims_] and its integer id at ids_[i], so a query
+ * walks flat arrays instead of chasing a heap allocation per node
+ *
+ * queries report the ids of the points they find, string labels are never stored in the tree but
+ * looked up by id in a LabelTable when results are output
+ *
+ * the arrays are either owned by the tree or point into a memory mapped binary kdtree file
+ *
+ * points are kept in inorder, so the points of every subtree occupy a contiguous index range, and
+ * nodes are kept in preorder, so a node is followed by its left subtree and then its right subtree
+ *
+ * subtrees of at most bucketSize() points are not split any further but stored as one leaf bucket
+ * whose points are scanned linearly, which cuts the node count by about the bucket size
+ *
+ * K is the compile time dimensionality of the stored points, 0 when chosen at runtime
  */
-template<typename T>
+template<typename T, std::size_t K = 0>
 class KDTree {
 
-    class KDNode;
-    
-    typedef std::shared_ptr<SplitPointStrategy<T>> SplitPointStrategyPtr;
-    typedef std::shared_ptr<SplitAxisStrategy<T>> SplitAxisStrategyPtr;
-    typedef std::shared_ptr<KDNode> KDNodePtr;
-    typedef std::pair<Point<T>,int> PointDimPair;
- 
-    public:
+    struct KDNode;
+    struct PresortedOrders;
+    
+    typedef std::shared_ptr<SplitPointStrategy<T,K>> SplitPointStrategyPtr;
+    typedef std::shared_ptr<SplitAxisStrategy<T,K>> SplitAxisStrategyPtr;
+    typedef std::uint32_t NodeIndex;
+    typedef std::pair<Point<T>,int> PointDimPair;
+ 
+    /*
+     * index used for a missing child or an empty tree
+     */
+    static const NodeIndex NIL = std::numeric_limits<NodeIndex>::max();
+
+    /*
+     * subtrees with fewer points than this are built on the thread that reaches them
+     */
+    static const std::size_t SUBTREE_CUTOFF = 4096;
+
+    /*
+     * nodes deeper than this many times the height of a balanced tree of the same points are split
+     * on their median whatever the split point strategy, so a strategy that doesn't split on the
+     * median, such as sliding midpoint on skewed data, keeps the height and the recursion of the
+     * build O(log n)
+     */
+    static const std::size_t DEPTH_LIMIT_FACTOR = 4;
+
+    template <typename U>
+    friend class BinaryFileWriter;
+
+    public:
+
+    /*
+     * builds kdtree given a list of points
+     * input pointcloud - list of points to put in kdtree
+     * input splitPointStrategy - decision algorithm to find median of input list of points and choose point to split on
+     * input splitAxisStrategy - decision algorithm to find axis to split on
+     */
+    KDTree(PointCloud<T,K> pointCloud,const SplitPointStrategyPtr splitPointStrategy,const SplitAxisStrategyPtr splitAxisStrategy) :
+        KDTree(std::move(pointCloud),splitPointStrategy,splitAxisStrategy,1) {}
+
+    /*
+     * builds kdtree given a list of points using a pool of worker threads, the tree is identical to the one built on a single thread
+     * input pointcloud - list of points to put in kdtree
+     * input splitPointStrategy - decision algorithm to find median of input list of points and choose point to split on
+     * input splitAxisStrategy - decision algorithm to find axis to split on
+     * input threads - number of worker threads, 0 picks one per hardware thread
+     * input bucketSize - largest number of points stored in one leaf, 1 splits down to single points
+     */
+    KDTree(PointCloud<T,K> pointCloud,const SplitPointStrategyPtr splitPointStrategy,const SplitAxisStrategyPtr splitAxisStrategy,const std::size_t& threads,
+           const std::size_t& bucketSize = 1) :
+        KDTree(pointCloud.release(),pointCloud.dims(),splitPointStrategy,splitAxisStrategy,threads,bucketSize,false) {}
+
+    /*
+     * builds a kdtree from a range of points, the points are copied straight into the tree without
+     * going through a pointcloud
+     * input first, last - range of points to put in kdtree, ids are kept and a point without one
+     *  gets its position in the range
+     * input splitPointStrategy - decision algorithm to find median of input list of points and choose point to split on
+     * input splitAxisStrategy - decision algorithm to find axis to split on
+     * input threads - number of worker threads, 0 picks one per hardware thread
+     * input bucketSize - largest number of points stored in one leaf, 1 splits down to single points
+     * input deduplicate - drop every point with the same coordinates as an earlier one in the range
+     * input monitor - optional, times the phases of the build and reports its progress
+     */
+    template <typename Iterator, typename = typename std::iterator_traits<Iterator>::iterator_category>
+    KDTree(Iterator first, Iterator last, const SplitPointStrategyPtr splitPointStrategy, const SplitAxisStrategyPtr splitAxisStrategy,
+           const std::size_t& threads = 1, const std::size_t& bucketSize = 1, const bool& deduplicate = false, BuildMonitor* monitor = nullptr) :
+        KDTree(std::vector<Point<T,K>>(first, last), K, splitPointStrategy, splitAxisStrategy, threads, bucketSize, deduplicate, monitor) {}
+
+    /*  
+     * builds a kdtree from a pcd file
+     */
+    KDTree(PCDFile<T,K>& pcdfile, const SplitPointStrategyPtr splitPointStrategy,const SplitAxisStrategyPtr splitAxisStrategy) :
+        KDTree(pcdfile,splitPointStrategy,splitAxisStrategy,1) {}
+
+    /*
+     * builds a kdtree from a pcd file using a pool of worker threads and leaves of up to bucketSize points,
+     * every point's id is its row in the file
+     * input deduplicate - keep only the first of the rows with the same coordinates
+     * input monitor - optional, times the phases of the build and reports its progress
+     *
+     * no point is ever made from a row, the build partitions the row numbers and copies each row's
+     * coordinates from the file straight into the tree once its place is known, the tree is the same
+     * one the points of the file would build
+     */
+    KDTree(PCDFile<T,K>& pcdfile, const SplitPointStrategyPtr splitPointStrategy,const SplitAxisStrategyPtr splitAxisStrategy,const std::size_t& threads,
+           const std::size_t& bucketSize = 1, const bool& deduplicate = false, BuildMonitor* monitor = nullptr)
+        : splitPointStrategy_(splitPointStrategy), splitAxisStrategy_(splitAxisStrategy), dims_(pcdfile.dims()),
+          points_(0), root_(NIL), bucketSize_(bucketSize), height_(0) {
+
+        if (K && pcdfile.points() > 0 && dims_ != K) {
+            throw std::runtime_error("Point dimensionality does not match");
+        }
+
+        // checked before numbering the rows, which wouldn't fit a row number
+        if (pcdfile.points() >= NIL) {
+            throw std::runtime_error(std::to_string(pcdfile.points()) + " points exceeds kdtree capacity");
+        }
+
+        Rows rows{pcdfile.coordinates().data(), dims_, std::vector<std::uint32_t>(pcdfile.points())};
+        std::iota(rows.rows_.begin(), rows.rows_.end(), 0);
+
+        if (deduplicate) {
+
+            if (monitor) monitor->begin("dedup", rows.size());
+            removeDuplicates(rows);
+            if (monitor) monitor->end();
+        }
+
+        BuildKDTree(rows, threads, monitor);
+    }
+
+    /*
+     * builds a kdtree from a pcd file with default strategies
+     */
+    KDTree(PCDFile<T,K>& pcdfile) : KDTree(
+        pcdfile,
+        std::make_shared<SplitPointSortStrategy<T,K>>(),
+        std::make_shared<SplitAxisRoundRobinStrategy<T,K>>()) {}
+
+    /*
+     * builds a kdtree from an initializer list
+     */
+    KDTree(const std::initializer_list<Point<T,K>>& vals) :
+        KDTree(vals,std::make_shared<SplitPointSortStrategy<T,K>>(),std::make_shared<SplitAxisRoundRobinStrategy<T,K>>()) {}
+
+    /*
+     * builds a kd tree given a graphviz dotfile
+     * input dotfile - handle to filestream containing a serialized pointcloud
+     */
+    KDTree(DotFileReader<T>& dotfile) : dims_(0), points_(0), root_(NIL), bucketSize_(1), height_(0) {
+
+        // get root from dot file
+        auto it = dotfile.begin();
+        root_ = buildNode(*it);
+
+        // enqueue root
+        std::queue<NodeIndex> q;
+        if (root_ != NIL) q.push(root_);
+
+        // build kdtree in level-order, nodes are appended to the node array in the order they are read
+        while(!q.empty()) {
+       
+            // current node
+            NodeIndex temp = q.front();
+            q.pop();
+
+            // children nodes, built before linking since appending may reallocate the node array
+            NodeIndex left = buildNode(*++it);
+            NodeIndex right = buildNode(*++it);
+            nodes_[temp].left_ = left;
+            nodes_[temp].right_ = right;
+
+            // enqueue children
+            if (left != NIL) q.push(left);
+            if (right != NIL) q.push(right);
+        }        
+
+        // nodes were appended in level order, restore the inorder point and preorder node layout
+        relayout();
+        compact();
+        computeBounds();
+    }
+
+    /*
+     * opens a kd tree in place from a memory mapped binary kdtree file, nothing is parsed or copied
+     * input file - mapped file written by BinaryFileWriter, kept mapped for as long as the kdtree lives
+     */
+    KDTree(const BinaryFileReader<T>& file) :
+        mapping_(file.mapping()), dims_(file.header().dims_), points_(file.header().points_), root_(NIL), bucketSize_(file.header().bucketSize_),
+        height_(file.header().height_) {
+
+        const BinaryFileHeader& header = file.header();
+
+        if (K && dims_ != K) {
+            throw std::runtime_error("Point dimensionality does not match");
+        }
+
+        if (header.nodeSize_ != sizeof(KDNode) || header.points_ >= NIL || header.nodes_ > header.points_) {
+            throw std::runtime_error("binary kdtree file does not match this kdtree's node layout");
+        }
+
+        if (header.nodes_ > 0 && header.root_ >= header.nodes_) {
+            throw std::runtime_error("binary kdtree file has an invalid root");
+        }
+
+        std::size_t points = header.points_;
+
+        root_ = header.nodes_ ? header.root_ : NIL;
+        nodes_.view(file.template section<KDNode>(header.nodesOffset_, header.nodes_), header.nodes_);
+        coordinates_.view(file.template section<T>(header.coordinatesOffset_, points * dims_), points * dims_);
+        ids_.view(file.template section<std::uint64_t>(header.idsOffset_, points), points);
+
+        // possible user error here, a corrupt file, nodes are checked once so queries can trust them,
+        // nodes are in preorder so every child lies after its parent, which also rules out cycles,
+        // and every subtree owns a contiguous range of points its root splits around its own point
+        // or, as a leaf, owns whole, so no range a query derives from a node can run past the points
+        if ((header.nodes_ == 0) != (points == 0)) {
+            throw std::runtime_error("binary kdtree file has an invalid root");
+        }
+
+        // read through the view, the non const operator[] only reaches owned nodes
+        const Storage<KDNode>& nodes = nodes_;
+
+        // node, first and last point of its subtree
+        std::vector<std::tuple<NodeIndex, std::uint64_t, std::uint64_t>> walk;
+        std::size_t visited = 0;
+
+        if (root_ != NIL) walk.emplace_back(root_, 0, points - 1);
+
+        while (!walk.empty()) {
+
+            NodeIndex i;
+            std::uint64_t first, last;
+            std::tie(i, first, last) = walk.back();
+            walk.pop_back();
+            visited++;
+
+            const KDNode& node = nodes[i];
+
+            bool childrenValid = (node.left_ == NIL || (node.left_ > i && node.left_ < header.nodes_)) &&
+                                 (node.right_ == NIL || (node.right_ > i && node.right_ < header.nodes_));
+
+            // a leaf owns every point of its range, an inner node owns one and its children the rest
+            bool rangeValid = (node.left_ == NIL && node.right_ == NIL) ?
+                (node.first_ == first && std::uint64_t(node.count_) == last - first + 1) :
+                (node.count_ == 1 && node.first_ >= first && node.first_ <= last &&
+                 (node.left_ != NIL) == (node.first_ > first) && (node.right_ != NIL) == (node.first_ < last));
+
+            if (node.dim_ >= dims_ || !childrenValid || !rangeValid || visited > header.nodes_) {
+                throw std::runtime_error("binary kdtree file has an invalid node " + std::to_string(i));
+            }
+
+            if (node.left_ != NIL) walk.emplace_back(node.left_, first, std::uint64_t(node.first_) - 1);
+            if (node.right_ != NIL) walk.emplace_back(node.right_, std::uint64_t(node.first_) + 1, last);
+        }
+
+        if (visited != header.nodes_) {
+            throw std::runtime_error("binary kdtree file has nodes outside its tree");
+        }
+
+        // bounds are stored rather than recomputed so opening never touches the coordinates
+        const T* bounds = file.template section<T>(header.boundsOffset_, 2 * dims_);
+        bounds_ = Cell<T,K>(dims());
+
+        if (points) {
+            std::copy(bounds, bounds + dims_, bounds_.min().begin());
+            std::copy(bounds + dims_, bounds + 2 * dims_, bounds_.max().begin());
+        }
+    }
+
+    // don't allow copying a kdtree to a new instance (well there is still a sneaky way to do it...)
+    // kdtrees could potentially be huge, one is enough... until the design review
+    KDTree(KDTree& other) = delete;
+
+    /*
+     * move a kdtree instance
+     */
+    KDTree(KDTree&& other) :
+        splitPointStrategy_(other.splitPointStrategy_), splitAxisStrategy_(other.splitAxisStrategy_) {
+
+       // other's node and coordinate arrays will now all be empty
+       this->nodes_ = std::move(other.nodes_);
+       this->coordinates_ = std::move(other.coordinates_);
+       this->ids_ = std::move(other.ids_);
+       this->bounds_ = std::move(other.bounds_);
+       this->dims_ = other.dims_;
+       this->points_ = other.points_;
+       this->root_ = other.root_;
+       this->bucketSize_ = other.bucketSize_;
+       this->height_ = other.height_;
+       this->mapping_ = std::move(other.mapping_);
+
+       other.dims_ = 0;
+       other.points_ = 0;
+       other.root_ = NIL;
+       other.height_ = 0;
+    }
+
+    /**
+     * begin iterator to walk tree in level order, points are runtime dimensioned so that
+     * the empty point can stand for a missing child whatever K is
+     *
+     * a leaf bucket yields only its first point, trees with buckets cannot be walked point by point
+     */
+    auto begin() {
+
+        return LevelorderIterator<PointDimPair>(this, root_);
+    }
+
+    auto begin() const {
+        
+        return LevelorderIterator<PointDimPair>(this, root_);
+    }
+
+    /**
+     * end iterator to signify all nodes in kdtree have been visited
+     */
+    auto end() {return LevelorderIterator<PointDimPair>();}
+
+    auto end() const {return LevelorderIterator<PointDimPair>();}
+
+    /*
+     * getter - dimensionality of points stored in kdtree, a compile time constant when K is fixed
+     */
+    std::size_t dims() const {return K ? K : dims_;}
+
+    /*
+     * getter - number of points stored in kdtree
+     */
+    std::size_t points() const {return points_;}
+
+    /*
+     * getter - number of nodes in kdtree, about points() / bucketSize() once leaves are bucketed
+     */
+    std::size_t nodes() const {return nodes_.size();}
+
+    /*
+     * getter - largest number of points stored in one leaf
+     */
+    std::size_t bucketSize() const {return bucketSize_;}
+
+    /*
+     * getter - number of nodes on the longest path from the root to a leaf, 0 for an empty tree
+     */
+    std::size_t height() const {return height_;}
+
+    /*
+     * getter - bytes of memory held by kdtree, arrays viewing a mapped binary file count too since
+     * they are paged in as the tree is queried, divide by points() for the cost of a point
+     */
+    std::size_t memoryUsage() const {
+
+        return sizeof(*this) + nodes_.bytes() + coordinates_.bytes() + ids_.bytes() + 2 * dims() * sizeof(T);
+    }
+
+    /*
+     * getter - point stored at an index reported by a query, indices run from 0 to points() - 1
+     */
+    Point<T,K> point(const std::size_t& index) const {return nodePoint(index);}
+
+    /*
+     * getter - id of the point stored at an index reported by a query
+     */
+    std::size_t id(const std::size_t& index) const {return ids_[index];}
+
+    /*
+     * getter - smallest cell containing every point stored in kdtree
+     */
+    const Cell<T,K>& bounds() const {return bounds_;}
+
+    /*
+     * queries tree for nearest neighbor of input point
+     * input queryPoint - point to search for nearest neighbor of
+     * input epsilon - approximation factor, the point returned is at most (1+epsilon) times farther
+     *  than the true nearest neighbor, 0 searches exactly
+     * output id of the point in kdtree that is closest to input point, Point::NO_ID for an empty tree,
+     *  its euclidean distance and the number of nodes in the tree visited
+     */
+    std::tuple<std::size_t, double, std::size_t> queryNearestNeighbor(const Point<T,K>& queryPoint, const double& epsilon = 0.0) const {
+
+        checkDims(queryPoint);
+
+        std::vector<NodeIndex> s;
+        s.reserve(height_ + 1);
+
+        return nearestNeighbor(queryPoint, epsilon, s);
+    }
+
+    /*
+     * helper nested class - scratch state of a query that is kept between queries so repeated
+     * queries never touch the heap, create one per thread and pass it to every query it runs
+     *
+     * the traversal stack never holds more than one node per level of the tree, so it is sized
+     * from the tree height once and never grows
+     */
+    class QueryContext {
+
+        public:
+
+        /*
+         * ctor sizes the scratch state for kdtree, the only allocation the context makes
+         */
+        QueryContext(const KDTree& kdtree) {stack_.reserve(kdtree.height() + 1);}
+
+        /*
+         * getter - work done by the last query run with this context, all zero unless
+         *  ROSSB83_QUERY_STATS is defined
+         */
+        const QueryStats& stats() const {return stats_;}
+
+        private:
+
+        friend class KDTree;
+
+        /*
+         * traversal stack, capacity covers every node on a path from the root
+         */
+        std::vector<NodeIndex> stack_;
+
+        /*
+         * work done by the last query
+         */
+        QueryStats stats_;
+
+    }; // class QueryContext
+
+    /*
+     * queries tree for nearest neighbor of input point without allocating
+     * input queryPoint - point to search for nearest neighbor of
+     * input context - scratch state reused across queries, created for this tree
+     * input epsilon - approximation factor, see queryNearestNeighbor
+     * output index of the nearest point, look it up with point(index) and id(index), and its squared
+     *  euclidean distance, an empty tree returns an index past points()
+     */
+    std::pair<std::size_t, double> queryNearestNeighbor(const Point<T,K>& queryPoint, QueryContext& context, const double& epsilon = 0.0) const {
+
+        checkDims(queryPoint);
+
+        std::size_t numnodesvisited;
+        return nearestNeighbor(queryPoint, epsilon, stack(context), numnodesvisited, &context.stats_);
+    }
+
+    /*
+     * queries tree for nearest neighbor of every input point using a pool of worker threads
+     * input queryPoints - points to search for nearest neighbors of
+     * input threads - number of worker threads, 0 picks one per hardware thread
+     * input epsilon - approximation factor, see queryNearestNeighbor
+     * output id of the nearest neighbor, euclidean distance and number of nodes visited per query point, in input order
+     */
+    std::vector<std::tuple<std::size_t, double, std::size_t>> queryNearestNeighbor(const std::vector<Point<T,K>>& queryPoints, const std::size_t& threads,
+        const double& epsilon = 0.0) const {
+
+        for (const Point<T,K>& queryPoint : queryPoints) checkDims(queryPoint);
+
+        return parallelQuery<std::tuple<std::size_t, double, std::size_t>>(queryPoints, threads,
+            [this, &epsilon](const Point<T,K>& queryPoint, Scratch& scratch) {return nearestNeighbor(queryPoint, epsilon, scratch.stack_);});
+    }
+   
+    /*
+     * queries tree for the k nearest neighbors of input point
+     * input queryPoint - point to search for nearest neighbors of
+     * input k - number of neighbors to return, fewer are returned if the tree holds less than k points
+     * input epsilon - approximation factor, the i-th point returned is at most (1+epsilon) times farther
+     *  than the true i-th nearest neighbor, 0 searches exactly
+     * output ids of the points in kdtree closest to input point and their euclidean distances, both
+     *  sorted by increasing distance, and the number of nodes in the tree visited
+     */
+    std::tuple<std::vector<std::size_t>, std::vector<double>, std::size_t> queryKNearest(const Point<T,K>& queryPoint, const std::size_t& k,
+        const double& epsilon = 0.0) const {
+
+        checkDims(queryPoint);
+
+        // sized once from the height so the traversal never grows it
+        std::vector<NodeIndex> s;
+        s.reserve(height_ + 1);
+
+        return kNearest(queryPoint, k, epsilon, s);
+    }
+
+    /*
+     * queries tree for the k nearest neighbors of every input point using a pool of worker threads
+     * input queryPoints - points to search for nearest neighbors of
+     * input k - number of neighbors to return per query point
+     * input threads - number of worker threads, 0 picks one per hardware thread
+     * input epsilon - approximation factor, see queryKNearest
+     * output ids of the nearest neighbors, euclidean distances and number of nodes visited per query point, in input order
+     */
+    std::vector<std::tuple<std::vector<std::size_t>, std::vector<double>, std::size_t>> queryKNearest(const std::vector<Point<T,K>>& queryPoints,
+        const std::size_t& k, const std::size_t& threads, const double& epsilon = 0.0) const {
+
+        for (const Point<T,K>& queryPoint : queryPoints) checkDims(queryPoint);
+
+        return parallelQuery<std::tuple<std::vector<std::size_t>, std::vector<double>, std::size_t>>(queryPoints, threads,
+            [this, &k, &epsilon](const Point<T,K>& queryPoint, Scratch& scratch) {return kNearest(queryPoint, k, epsilon, scratch.stack_);});
+    }
+
+    /*
+     * queries tree for nearest neighbor of input point with a hard limit on the work done, branches
+     * are explored closest first (best-bin-first) until maxChecks points have been checked
+     * input queryPoint - point to search for nearest neighbor of
+     * input maxChecks - largest number of points whose distance is checked
+     * output id of the nearest point found, its euclidean distance, the number of nodes in the tree visited and
+     *  whether the search proved the point is the true nearest neighbor before running out of checks
+     */
+    std::tuple<std::size_t, double, std::size_t, bool> queryBestBinFirst(const Point<T,K>& queryPoint, const std::size_t& maxChecks) const {
+
+        checkDims(queryPoint);
+
+        std::vector<std::pair<double, NodeIndex>> bins;
+        return bestBinFirst(queryPoint, maxChecks, bins);
+    }
+
+    /*
+     * queries tree for nearest neighbor of every input point with a limit on the work done per
+     * query, using a pool of worker threads
+     * input queryPoints - points to search for nearest neighbors of
+     * input maxChecks - largest number of points whose distance is checked per query point
+     * input threads - number of worker threads, 0 picks one per hardware thread
+     * output results of queryBestBinFirst per query point, in input order
+     */
+    std::vector<std::tuple<std::size_t, double, std::size_t, bool>> queryBestBinFirst(const std::vector<Point<T,K>>& queryPoints,
+        const std::size_t& maxChecks, const std::size_t& threads) const {
+
+        for (const Point<T,K>& queryPoint : queryPoints) checkDims(queryPoint);
+
+        return parallelQuery<std::tuple<std::size_t, double, std::size_t, bool>>(queryPoints, threads,
+            [this, &maxChecks](const Point<T,K>& queryPoint, Scratch& scratch) {return bestBinFirst(queryPoint, maxChecks, scratch.bins_);});
+    }
+
+    /*
+     * queries tree for every point within a distance of input point
+     * input queryPoint - point to search around
+     * input radius - euclidean distance from query point to search within, inclusive
+     * output ids of the points in kdtree within radius of input point and their euclidean distances,
+     *  both sorted by increasing distance, and the number of nodes in the tree visited
+     */
+    std::tuple<std::vector<std::size_t>, std::vector<double>, std::size_t> queryRadius(const Point<T,K>& queryPoint, const double& radius) const {
+
+        std::vector<std::size_t> neighbors;
+        std::size_t numnodesvisited = queryRadius(queryPoint, radius, neighbors);
+
+        // pair distances with indices to sort them together
+        std::vector<std::pair<double, std::size_t>> nearestNeighbors;
+        nearestNeighbors.reserve(neighbors.size());
+
+        for (std::size_t neighbor : neighbors) {
+            nearestNeighbors.push_back(std::make_pair(distance(queryPoint, neighbor), neighbor));
+        }
+
+        std::sort(nearestNeighbors.begin(), nearestNeighbors.end());
+
+        std::vector<std::size_t> ids;
+        std::vector<double> distances;
+        ids.reserve(nearestNeighbors.size());
+        distances.reserve(nearestNeighbors.size());
+
+        for (const auto& nearestNeighbor : nearestNeighbors) {
+
+            ids.push_back(ids_[nearestNeighbor.second]);
+            distances.push_back(sqrt(nearestNeighbor.first));
+        }
+
+        return std::make_tuple(std::move(ids), std::move(distances), numnodesvisited);
+
+    } // end function queryRadius
+
+    /*
+     * queries tree for every point within a distance of input point into a caller-owned buffer, the
+     * traversal stack is allocated once per call, use the QueryContext overload in a loop
+     * input queryPoint - point to search around
+     * input radius - euclidean distance from query point to search within, inclusive
+     * input neighbors - cleared and filled with the index of every point found, in no particular
+     *  order, look the points up with point(index) and their ids with id(index)
+     * output number of nodes in the tree visited
+     */
+    std::size_t queryRadius(const Point<T,K>& queryPoint, const double& radius, std::vector<std::size_t>& neighbors) const {
+
+        QueryContext context(*this);
+        return queryRadius(queryPoint, radius, neighbors, context);
+    }
+
+    /*
+     * queries tree for every point within a distance of input point without allocating, meant to be
+     * called in a loop with the same buffer and context, only a neighbors buffer too small for the
+     * points found grows
+     * input queryPoint - point to search around
+     * input radius - euclidean distance from query point to search within, inclusive
+     * input neighbors - cleared and filled with the index of every point found, in no particular
+     *  order, look the points up with point(index) and their ids with id(index)
+     * input context - scratch state reused across queries, created for this tree
+     * output number of nodes in the tree visited
+     */
+    std::size_t queryRadius(const Point<T,K>& queryPoint, const double& radius, std::vector<std::size_t>& neighbors, QueryContext& context) const {
+
+        checkDims(queryPoint);
+        neighbors.clear();
+
+        // the bound never tightens, every branch within radius of the query point is explored
+        const double searchDistance = radius * radius;
+
+        // lambda to collect every node within radius
+        auto updateNeighbors = [this, &queryPoint, &searchDistance, &neighbors](NodeIndex p) {
+            if (distance(queryPoint, p, searchDistance) <= searchDistance) neighbors.push_back(p);
+        };
+
+        // lambda to bound the search by the fixed radius
+        auto searchRadius = [&searchDistance]() {return searchDistance;};
+
+        return searchTree(queryPoint, updateNeighbors, searchRadius, stack(context), &context.stats_);
+
+    } // end function queryRadius
+
+    /*
+     * queries tree for every point inside an axis-aligned box
+     * input min - corner of the box with the smallest value in every dimension
+     * input max - corner of the box with the largest value in every dimension, bounds are inclusive
+     * output ids of the points in kdtree inside the box, in no particular order, and the number of nodes in the tree visited
+     */
+    std::tuple<std::vector<std::size_t>, std::size_t> queryBox(const Point<T,K>& min, const Point<T,K>& max) const {
+
+        std::vector<std::size_t> indices;
+        std::size_t numnodesvisited = queryBox(min, max, indices);
+
+        // indices are replaced by ids in place
+        for (std::size_t& index : indices) {
+            index = ids_[index];
+        }
+
+        return std::make_tuple(std::move(indices), numnodesvisited);
+
+    } // end function queryBox
+
+    /*
+     * queries tree for every point inside an axis-aligned box into a caller-owned buffer, meant to
+     * be called in a loop with the same buffer
+     * input min - corner of the box with the smallest value in every dimension
+     * input max - corner of the box with the largest value in every dimension, bounds are inclusive
+     * input indices - cleared and filled with the index of every point found, look the points up with
+     *  point(index) and their ids with id(index)
+     * output number of nodes in the tree visited
+     *
+     * the cell of each subtree is narrowed on the way down, a subtree whose cell lies inside the box
+     * is reported as a whole from its index range and a subtree whose cell misses the box is skipped,
+     * so points are only tested one by one along the boundary of the box
+     */
+    std::size_t queryBox(const Point<T,K>& min, const Point<T,K>& max, std::vector<std::size_t>& indices) const {
+
+        checkDims(min);
+        checkDims(max);
+        indices.clear();
+
+        if (root_ == NIL) return 0;
+
+        Cell<T,K> box(min, max);
+        Cell<T,K> cell(bounds_);
+        std::size_t numnodesvisited = 0;
+
+        searchBox(box, root_, 0, points_ - 1, cell, indices, numnodesvisited);
+
+        return numnodesvisited;
+
+    } // end function queryBox
+
+    /*
+     * compares two kdtrees for inequality
+     */
+    bool operator!=(const KDTree& other) const {
+
+        return !(this->operator==(other));
+    }
+
+    /*
+     * compares two kdtrees for equality
+     */
+    bool operator==(const KDTree& other) const {
+    
+        // roots of trees
+        NodeIndex rootA = this->root_;
+        NodeIndex rootB = other.root_;
+
+        // enqueue both trees
+        std::queue<NodeIndex> qA;
+        std::queue<NodeIndex> qB;
+
+        if (rootA != NIL) qA.push(rootA);
+        if (rootB != NIL) qB.push(rootB);
+
+        // iterate through trees in level order
+        while (!qA.empty() && !qB.empty()) {
+
+            // examine nodes in level order
+            const KDNode& tempA = this->nodes_[qA.front()];
+            const KDNode& tempB = other.nodes_[qB.front()];
+
+            // check for equality
+            if ((tempA.dim_ != tempB.dim_) || (tempA.count_ != tempB.count_)) {
+                return false;
+            }
+
+            for (std::uint32_t i = 0; i < tempA.count_; i++) {
+
+                if (this->nodePoint(tempA.first_ + i) != other.nodePoint(tempB.first_ + i)) return false;
+            }
+
+            qA.pop();
+            qB.pop();
+
+            if ((tempA.left_ == NIL) != (tempB.left_ == NIL)) return false;
+            if ((tempA.right_ == NIL) != (tempB.right_ == NIL)) return false;
+
+            // enqueue nodes
+            if (tempA.left_ != NIL) qA.push(tempA.left_);
+            if (tempA.right_ != NIL) qA.push(tempA.right_);
+            if (tempB.left_ != NIL) qB.push(tempB.left_);
+            if (tempB.right_ != NIL) qB.push(tempB.right_);
+        }
+
+        // make sure both trees are same length
+        return (qA.empty() != qB.empty()) ? false : true;
+    }
+
+    private:
+
+    /*
+     * builds kdtree from a vector of points, shared by the constructors that don't go through a pointcloud
+     * input dims - dimensionality of the tree when there are no points to take it from
+     * input monitor - optional, times the phases of the build and reports its progress
+     */
+    KDTree(std::vector<Point<T,K>>&& points, const std::size_t& dims, const SplitPointStrategyPtr splitPointStrategy,
+           const SplitAxisStrategyPtr splitAxisStrategy, const std::size_t& threads, const std::size_t& bucketSize, const bool& deduplicate,
+           BuildMonitor* monitor = nullptr)
+        : splitPointStrategy_(splitPointStrategy), splitAxisStrategy_(splitAxisStrategy), dims_(points.empty() ? dims : points.front().dims()),
+          points_(0), root_(NIL), bucketSize_(bucketSize), height_(0) {
+
+        for (std::size_t i = 0; i < points.size(); i++) {
+
+            if (points[i].dims() != dims_) {
+                throw std::runtime_error("Point dimensionality does not match");
+            }
+
+            // points without an id are named by their position in the input, before any are dropped
+            if (points[i].id() == Point<T,K>::NO_ID) points[i].id(i);
+        }
+
+        if (deduplicate) {
+
+            if (monitor) monitor->begin("dedup", points.size());
+            removeDuplicates(points);
+            if (monitor) monitor->end();
+        }
+
+        BuildKDTree(points, threads, monitor);
+    }
+
+    /*
+     * helper nested struct - points of a pcd file referred to by their row, a build rearranges the
+     * rows where it would rearrange points and reads the coordinates of a row from the file
+     */
+    struct Rows {
+
+        /*
+         * coordinates of every row of the file back to back, row r starts at coordinates_[r * dims_]
+         */
+        const T* coordinates_;
+
+        std::size_t dims_;
+
+        /*
+         * rows of the points being built, in the order the build has arranged them
+         */
+        std::vector<std::uint32_t> rows_;
+
+        std::size_t size() const {return rows_.size();}
+
+    }; // struct Rows
+
+    /*
+     * helper functions the build reads and rearranges its points or rows through, so one build
+     * serves both, point i is the i-th of the build's current order
+     */
+    static const T* coordinates(const std::vector<Point<T,K>>& points, const std::size_t& i) {return points[i].data();}
+
+    static const T* coordinates(const Rows& rows, const std::size_t& i) {return rows.coordinates_ + rows.rows_[i] * rows.dims_;}
+
+    static std::uint64_t id(const std::vector<Point<T,K>>& points, const std::size_t& i) {return points[i].id();}
+
+    static std::uint64_t id(const Rows& rows, const std::size_t& i) {return rows.rows_[i];}
+
+    static void exchange(std::vector<Point<T,K>>& points, const std::size_t& i, const std::size_t& j) {swap(points[i], points[j]);}
+
+    static void exchange(Rows& rows, const std::size_t& i, const std::size_t& j) {std::swap(rows.rows_[i], rows.rows_[j]);}
+
+    static void truncate(std::vector<Point<T,K>>& points, const std::size_t& size) {points.erase(points.begin() + size, points.end());}
+
+    static void truncate(Rows& rows, const std::size_t& size) {rows.rows_.resize(size);}
+
+    std::size_t splitAxis(const std::vector<Point<T,K>>& points, const int& start, const int& stop, const std::size_t& depth, const Cell<T,K>& cell) const {
+
+        return splitAxisStrategy_->splitAxis(points, start, stop, depth, cell);
+    }
+
+    std::size_t splitAxis(const Rows& rows, const int& start, const int& stop, const std::size_t& depth, const Cell<T,K>& cell) const {
+
+        return splitAxisStrategy_->splitAxis(rows.coordinates_, rows.dims_, rows.rows_, start, stop, depth, cell);
+    }
+
+    std::size_t splitIndex(std::vector<Point<T,K>>& points, const std::size_t& axis, const int& start, const int& stop, const Cell<T,K>& cell) const {
+
+        return splitPointStrategy_->splitIndex(points, axis, start, stop, cell);
+    }
+
+    std::size_t splitIndex(Rows& rows, const std::size_t& axis, const int& start, const int& stop, const Cell<T,K>& cell) const {
+
+        return splitPointStrategy_->splitIndex(rows.coordinates_, rows.dims_, rows.rows_, axis, start, stop, cell);
+    }
+
+    std::size_t medianIndex(std::vector<Point<T,K>>& points, const std::size_t& axis, const int& start, const int& stop) const {
+
+        return splitPointStrategy_->medianIndex(points, axis, start, stop);
+    }
+
+    std::size_t medianIndex(Rows& rows, const std::size_t& axis, const int& start, const int& stop) const {
+
+        return splitPointStrategy_->medianIndex(rows.coordinates_, rows.dims_, rows.rows_, axis, start, stop);
+    }
+
+    /*
+     * helper function to find the depth past which every node is split on its median, see DEPTH_LIMIT_FACTOR
+     * input points - number of points in the tree
+     */
+    static std::size_t depthLimit(const std::size_t& points) {
+
+        std::size_t balanced = 1;
+        while (balanced < std::numeric_limits<std::size_t>::digits && (std::size_t(1) << balanced) <= points) balanced++;
+
+        return DEPTH_LIMIT_FACTOR * balanced;
+    }
+
+    /*
+     * helper function to drop every point with the same coordinates as an earlier one, the points
+     * left keep their order
+     *
+     * indices are sorted by coordinates so duplicates end up next to each other, earliest first,
+     * which needs no hashing and works whatever the coordinates look like
+     */
+    template <typename Points>
+    void removeDuplicates(Points& points) const {
+
+        std::vector<std::size_t> order(points.size());
+        std::iota(order.begin(), order.end(), 0);
+
+        auto less = [this, &points](const std::size_t& a, const std::size_t& b) {
+            const T* pa = coordinates(points, a);
+            const T* pb = coordinates(points, b);
+            return std::lexicographical_compare(pa, pa + dims_, pb, pb + dims_);
+        };
+
+        std::sort(order.begin(), order.end(), [&less](const std::size_t& a, const std::size_t& b) {
+            return less(a, b) || (!less(b, a) && a < b);
+        });
+
+        std::vector<bool> duplicate(points.size(), false);
+
+        for (std::size_t i = 1; i < order.size(); i++) {
+            if (!less(order[i - 1], order[i])) duplicate[order[i]] = true;
+        }
+
+        std::size_t kept = 0;
+
+        for (std::size_t i = 0; i < points.size(); i++) {
+
+            if (duplicate[i]) continue;
+            if (kept != i) exchange(points, kept, i);
+            kept++;
+        }
+
+        truncate(points, kept);
+    }
+
+    /*
+     * helper function to construct kd tree given a list of points
+     * input points - list of points or rows of a pcd file to move into kdtree
+     * input threads - number of worker threads, 1 builds on the calling thread and 0 picks one per hardware thread
+     * input monitor - optional, times allocating the arrays, presorting, splitting and compacting, and
+     *  reports the progress of splitting
+     *
+     * a subtree built from points [start,stop] stores its split point at index mid, so the point
+     * arrays end up in inorder and every subtree owns a contiguous range of them
+     *
+     * axis strategies only see the depth and cell of a node, so the tree is identical whatever
+     * order the subtrees are built in or however many threads build them
+     */
+    template <typename Points>
+    void BuildKDTree(Points& points, const std::size_t& threads, BuildMonitor* monitor = nullptr) {
+        
+        if (points.size() >= NIL) {
+            throw std::runtime_error(std::to_string(points.size()) + " points exceeds kdtree capacity");
+        }
+
+        if (bucketSize_ == 0) {
+            throw std::runtime_error("kdtree bucket size must be at least 1");
+        }
+
+        if (monitor) monitor->begin("allocate", points.size());
+
+        // a tree never has more nodes than points, nodes are built into the slot of their first
+        // point and compacted once the tree is built, allocate the flat arrays up front
+        nodes_.resize(points.size());
+        coordinates_.resize(points.size() * dims_);
+        ids_.resize(points.size());
+        points_ = points.size();
+
+        // the root covers the smallest cell containing every point
+        bounds_ = Cell<T,K>(dims());
+
+        if (points.size() == 0) {
+
+            if (monitor) monitor->end();
+            return;
+        }
+
+        for (std::size_t i = 0; i < dims(); i++) {
+
+            bounds_.min()[i] = std::numeric_limits<T>::max();
+            bounds_.max()[i] = std::numeric_limits<T>::lowest();
+        }
+          
+        for (std::size_t p = 0; p < points.size(); p++) {
+
+            const T* point = coordinates(points, p);
+
+            for (std::size_t i = 0; i < dims(); i++) {
+
+                bounds_.min()[i] = std::min(bounds_.min()[i], point[i]);
+                bounds_.max()[i] = std::max(bounds_.max()[i], point[i]);
+            }
+        }
+
+        if (monitor) monitor->end();
+
+        std::unique_ptr<ThreadPool> pool(threads == 1 ? nullptr : new ThreadPool(threads));
+        std::unique_ptr<PresortedOrders> presort;
+
+        if (splitPointStrategy_->presorted()) {
+
+            if (monitor) monitor->begin("presort", points.size());
+            presort.reset(new PresortedOrders(points, dims(), pool.get()));
+            if (monitor) monitor->end();
+        }
+
+        Cell<T,K> cell(bounds_);
+
+        if (monitor) monitor->begin("split", points.size());
+
+        root_ = buildSubtree(points, 0, points.size() - 1, 0, cell, presort.get(), pool.get(), monitor);
+
+        // a tree small enough to be built as one subtree never reported its progress
+        if (monitor && points.size() <= SUBTREE_CUTOFF) monitor->advance(points.size());
+        if (monitor) monitor->end();
+
+        if (monitor) monitor->begin("compact", points.size());
+        compact();
+        if (monitor) monitor->end();
+    }
+
+    /*
+     * helper function to recursively build the subtree of a range of points
+     * input points - list of points or rows of a pcd file to move into kdtree
+     * input start - inclusive index of the first point
+     * input stop - inclusive index of the last point
+     * input depth - depth of the subtree's root, 0 at the root of the tree
+     * input cell - cell of space the subtree covers, narrowed while descending and restored on return
+     * input presort - per axis orders to split on, null to ask the split point strategy at every node
+     * input pool - workers to fork large left subtrees onto, null to build on the calling thread
+     * input monitor - optional, counts the points placed, large nodes report their own point and
+     *  those of their children with at most SUBTREE_CUTOFF points once built, so progress costs
+     *  nothing inside the small subtrees where nearly every node is
+     * output index of the subtree's root, NIL for an empty range
+     */
+    template <typename Points>
+    NodeIndex buildSubtree(Points& points, const int& start, const int& stop, const std::size_t& depth,
+                           Cell<T,K>& cell, PresortedOrders* presort, ThreadPool* pool, BuildMonitor* monitor = nullptr) {
+
+        const int CUTOFF = static_cast<int>(SUBTREE_CUTOFF);
+
+        if (start > stop) return NIL;
+
+        // short ranges stop splitting and become a bucket that is scanned linearly, a single point
+        // is still split on so a bucket size of 1 builds the plain one point per node tree
+        if (start < stop && stop - start < static_cast<int>(bucketSize_)) return buildBucket(points, start, stop);
+
+        std::size_t axis = splitAxis(points, start, stop, depth, cell);
+        int mid = presort ? buildPresortedNode(points, start, stop, axis, *presort) :
+                            buildNode(points, start, stop, axis, cell, depth >= depthLimit(points.size()));
+        T split = nodes_[mid].split_;
+
+        // the left subtree goes to the pool with its own cell, the right one is built meanwhile
+        std::future<NodeIndex> left;
+
+        if (pool && mid - start > CUTOFF) {
+
+            Cell<T,K> leftCell(cell);
+            leftCell.max()[axis] = split;
+
+            left = pool->submit([this, &points, start, mid, depth, leftCell, presort, pool, monitor]() mutable {
+                return buildSubtree(points, start, mid - 1, depth + 1, leftCell, presort, pool, monitor);
+            });
+
+        } else {
+
+            T max = cell.max()[axis];
+            cell.max()[axis] = split;
+            nodes_[mid].left_ = buildSubtree(points, start, mid - 1, depth + 1, cell, presort, pool, monitor);
+            cell.max()[axis] = max;
+        }
+
+        T min = cell.min()[axis];
+        cell.min()[axis] = split;
+        nodes_[mid].right_ = buildSubtree(points, mid + 1, stop, depth + 1, cell, presort, pool, monitor);
+        cell.min()[axis] = min;
+
+        if (left.valid()) nodes_[mid].left_ = pool->wait(left);
+
+        if (monitor && stop - start >= CUTOFF) {
+
+            auto small = [&CUTOFF](const int& count) {return (count <= CUTOFF) ? count : 0;};
+            monitor->advance(1 + small(mid - start) + small(stop - mid));
+        }
+
+        return mid;
+    } 
+
+    /*
+     * helper function to find the node built from a range of points
+     * input start - inclusive index of the first point
+     * input stop - inclusive index of the last point
+     * output index of the range's median, where presorted builds place the split point
+     */
+    static NodeIndex midpoint(const int& start, const int& stop) {
+
+        return (start > stop) ? NIL : static_cast<NodeIndex>(std::ceil((start + stop)/2.0));
+    }
+
+    /*
+     * helper nested struct - node to store data in KDTree, kept small and free of heap
+     * data so the whole tree is a single allocation
+     *
+     * a node owns the points first_ to first_ + count_ - 1, an inner node owns just its split
+     * point while a leaf bucket owns up to bucketSize_ points and has neither children nor split
+     */
+    struct KDNode {
+
+        /*
+         * coordinate of this node's point at dim_, cached next to the child links
+         */
+        T split_;
+
+        /*
+         * dimension to compare left/right child points to
+         */
+        std::uint32_t dim_;
+
+        /*
+         * left child, less than parent node @dim
+         */
+        NodeIndex left_;
+
+        /*
+         * right child, greater than parent node @dim
+         */
+        NodeIndex right_;
+
+        /*
+         * index of the first point owned by this node
+         */
+        std::uint32_t first_;
+
+        /*
+         * number of points owned by this node
+         */
+        std::uint32_t count_;
+
+    }; // struct KDNode
+
+    /*
+     *  helper function to build node (used for in-memory pointcloud container and pcd files)
+     *  input points - point vector or rows of a pcd file to be copied into tree
+     *  input start - inclusive index of point vector to start selection of split point
+     *  input stop - inclusive index of point vector to stop selection of split point
+     *  input splitAxis - axis to split on
+     *  input cell - cell of space the node covers
+     *  input median - split on the median rather than where the split point strategy would, past the depth limit
+     *  output index of the node, which is also the index of the split point in points
+     */
+    template <typename Points>
+    NodeIndex buildNode(Points& points, const int& start, const int& stop, const std::size_t& splitAxis, const Cell<T,K>& cell,
+                        const bool& median = false) {
+
+        // decide point to split on, the strategy moves it to the index the node is built at
+        NodeIndex index = median ? medianIndex(points, splitAxis, start, stop) : splitIndex(points, splitAxis, start, stop, cell);
+        const T* splitPoint = coordinates(points, index);
+
+        std::copy(splitPoint, splitPoint + dims_, &coordinates_[index * dims_]);
+        ids_[index] = id(points, index);
+        nodes_[index] = {splitPoint[splitAxis], static_cast<std::uint32_t>(splitAxis), NIL, NIL, index, 1};
+
+        return index;
+    }
+
+    /*
+     *  helper function to build a node splitting a range of points on the median of a presorted order
+     *  input points - point vector or rows holding the range, rearranged so the split point sits at mid and
+     *   each side of it holds the points of one child
+     *  input start - inclusive index of the first point to consider
+     *  input stop - inclusive index of the last point to consider
+     *  input splitAxis - axis to split on
+     *  input presort - orders of the range along every axis, split into the orders of both children
+     *  output index of the node, which is also the index of the split point in points
+     *
+     *  points are moved into their rank along the split axis, so the median is read off the order
+     *  rather than searched for and the orders of the other axes are split in one stable pass each,
+     *  no point is ever copied or compared
+     */
+    template <typename Points>
+    NodeIndex buildPresortedNode(Points& points, const int& start, const int& stop, const std::size_t& splitAxis,
+                                 PresortedOrders& presort) {
+
+        NodeIndex index = midpoint(start, stop);
+        std::vector<std::uint32_t>& order = presort.orders_[splitAxis];
+        std::vector<std::uint32_t>& position = presort.position_;
+        std::vector<std::uint32_t>& scratch = presort.scratch_;
+
+        // every point moves to its rank along the split axis
+        for (int i = start; i <= stop; i++) position[order[i]] = i;
+
+        // the other orders keep their sequence on either side of the split, renumbered to the new positions
+        for (std::size_t axis = 0; axis < dims(); axis++) {
+
+            if (axis == splitAxis) continue;
+
+            std::vector<std::uint32_t>& other = presort.orders_[axis];
+            std::uint32_t left = start;
+            std::uint32_t right = index + 1;
+
+            for (int i = start; i <= stop; i++) {
+
+                std::uint32_t p = position[other[i]];
+
+                if (p < index) scratch[left++] = p;
+                else if (p > index) scratch[right++] = p;
+            }
+
+            std::copy(scratch.begin() + start, scratch.begin() + stop + 1, other.begin() + start);
+        }
+
+        std::iota(order.begin() + start, order.begin() + stop + 1, static_cast<std::uint32_t>(start));
+
+        // move points along the cycles of the permutation
+        for (std::uint32_t i = start; i <= static_cast<std::uint32_t>(stop); i++) {
+
+            while (position[i] != i) {
+
+                std::uint32_t target = position[i];
+                exchange(points, i, target);
+                std::swap(position[i], position[target]);
+            }
+        }
+
+        const T* splitPoint = coordinates(points, index);
+
+        std::copy(splitPoint, splitPoint + dims_, &coordinates_[index * dims_]);
+        ids_[index] = id(points, index);
+        nodes_[index] = {splitPoint[splitAxis], static_cast<std::uint32_t>(splitAxis), NIL, NIL, index, 1};
+
+        return index;
+    }
+
+    /*
+     * helper nested struct - order of the points along every axis for a presorted build, the
+     * orders of a subtree occupy the same index range as its points so concurrent subtrees
+     * never touch the same entries
+     */
+    struct PresortedOrders {
+
+        /*
+         * sorts the indices of the points once per axis, ties broken by index
+         */
+        template <typename Points>
+        PresortedOrders(const Points& points, const std::size_t& dims, ThreadPool* pool) :
+            orders_(dims, std::vector<std::uint32_t>(points.size())), position_(points.size()), scratch_(points.size()) {
+
+            std::vector<std::future<void>> sorts;
+
+            for (std::size_t axis = 0; axis < dims; axis++) {
+
+                // coordinates are gathered next to their index first so sorting never chases a point
+                auto sort = [&points, axis, this]() {
+
+                    std::vector<std::pair<T, std::uint32_t>> keys(points.size());
+
+                    for (std::uint32_t i = 0; i < points.size(); i++) keys[i] = std::make_pair(coordinates(points, i)[axis], i);
+
+                    std::sort(keys.begin(), keys.end());
+
+                    std::vector<std::uint32_t>& order = orders_[axis];
+                    for (std::size_t i = 0; i < keys.size(); i++) order[i] = keys[i].second;
+                };
+
+                if (pool) sorts.push_back(pool->submit(sort));
+                else sort();
+            }
+
+            for (std::future<void>& sorted : sorts) pool->wait(sorted);
+        }
+
+        /*
+         * per axis, index of every point of a range sorted by its coordinate along the axis
+         */
+        std::vector<std::vector<std::uint32_t>> orders_;
+
+        /*
+         * new index of every point while splitting a range
+         */
+        std::vector<std::uint32_t> position_;
+
+        /*
+         * buffer to split an order into
+         */
+        std::vector<std::uint32_t> scratch_;
+
+    }; // struct PresortedOrders
+
+    /*
+     *  helper function to build a leaf bucket holding a range of points as they are
+     *  input points - point vector or rows of a pcd file to be copied into tree
+     *  input start - inclusive index of the first point of the bucket
+     *  input stop - inclusive index of the last point of the bucket
+     *  output index of the node, which is also the index of the bucket's first point
+     */
+    template <typename Points>
+    NodeIndex buildBucket(const Points& points, const int& start, const int& stop) {
+
+        for (int i = start; i <= stop; i++) {
+
+            std::copy(coordinates(points, i), coordinates(points, i) + dims_, &coordinates_[i * dims_]);
+            ids_[i] = id(points, i);
+        }
+
+        nodes_[start] = {T(), 0, NIL, NIL, static_cast<std::uint32_t>(start), static_cast<std::uint32_t>(stop - start + 1)};
+
+        return start;
+    }
+
+    /*
+     * helper function to build node (used for dot file deserialization)
+     * input p - point/dimension to be appended to the node array
+     */
+    NodeIndex buildNode(const PointDimPair& p) {
+
+        if (p.first == Point<T>()) return NIL;
+
+        // the first point read decides the dimensionality of the tree
+        if (nodes_.empty()) dims_ = p.first.dims();
+
+        if (dims_ != p.first.dims() || (K && dims_ != K)) {
+            throw std::runtime_error("Point dimensionality does not match");
+        }
+
+        NodeIndex index = nodes_.size();
+
+        nodes_.push_back({p.first[p.second], static_cast<std::uint32_t>(p.second), NIL, NIL, index, 1});
+        coordinates_.append(p.first.begin(), p.first.end());
+        ids_.push_back((p.first.id() == Point<T>::NO_ID) ? index : p.first.id());
+        points_++;
+
+        return index;
+    }
+
+    /*
+     * helper function to refuse a query point whose dimensionality differs from the tree's, its
+     * coordinates would be read past their end, a tree that never held points has no dimensionality
+     */
+    void checkDims(const Point<T,K>& queryPoint) const {
+
+        if (dims_ && queryPoint.dims() != dims_) {
+            throw std::runtime_error("Point dimensionality does not match");
+        }
+    }
+
+    /*
+     * helper function to get the traversal stack of a context, a context created for a smaller tree
+     * grows once here, never during the traversal
+     */
+    std::vector<NodeIndex>& stack(QueryContext& context) const {
+
+        if (context.stack_.capacity() <= height_) context.stack_.reserve(height_ + 1);
+        return context.stack_;
+    }
+
+    /*
+     * helper function to query the nearest neighbor of input point
+     * input queryPoint - point to search for nearest neighbor of
+     * input epsilon - approximation factor, 0 searches exactly
+     * input s - scratch stack for the traversal, reused across queries on the same thread
+     */
+    std::tuple<std::size_t, double, std::size_t> nearestNeighbor(const Point<T,K>& queryPoint, const double& epsilon, std::vector<NodeIndex>& s) const {
+
+        std::size_t numnodesvisited;
+        std::pair<std::size_t, double> nearest = nearestNeighbor(queryPoint, epsilon, s, numnodesvisited);
+
+        return std::make_tuple(nodeId(nearest.first), sqrt(nearest.second), numnodesvisited);
+    }
+
+    /*
+     * helper function to query the index and squared distance of the nearest neighbor of input point
+     * input numnodesvisited - set to the number of nodes visited
+     * input stats - optional, set to the work done by the traversal when QUERY_STATS_ENABLED
+     */
+    std::pair<std::size_t, double> nearestNeighbor(const Point<T,K>& queryPoint, const double& epsilon, std::vector<NodeIndex>& s,
+        std::size_t& numnodesvisited, QueryStats* stats = nullptr) const {
+
+        const double shrink = approximation(epsilon);
+
+        // initialize nearest neighbor/distance as no node at distance infinity
+        NodeIndex nearestNeighbor = NIL;
+        double nearestDistance = std::numeric_limits<double>::max();
+
+        // lambda to update nearest neighbor, only the index is kept until the search is done
+        auto updateNearestNeighbor = [this, &queryPoint, &nearestNeighbor, &nearestDistance](NodeIndex p) {
+
+            double queryDistance = distance(queryPoint, p, nearestDistance);
+
+            if(queryDistance < nearestDistance) {
+
+                nearestDistance = queryDistance;
+                nearestNeighbor = p;
+            }
+        };
+
+        // lambda to bound the search by the nearest neighbor found so far, shrunk when approximating
+        auto searchRadius = [&nearestDistance, &shrink]() {return nearestDistance * shrink;};
+
+        numnodesvisited = searchTree(queryPoint, updateNearestNeighbor, searchRadius, s, stats);
+
+        return std::make_pair(nearestNeighbor, nearestDistance);
+
+    } // end function nearestNeighbor
+
+    /*
+     * helper function to query the k nearest neighbors of input point
+     * input queryPoint - point to search for nearest neighbors of
+     * input k - number of neighbors to return
+     * input epsilon - approximation factor, 0 searches exactly
+     * input s - scratch stack for the traversal, reused across queries on the same thread
+     *
+     * candidates are kept in a max-heap bounded to k entries, so once k points are found the search
+     * is pruned against the distance of the k-th best rather than the best
+     */
+    std::tuple<std::vector<std::size_t>, std::vector<double>, std::size_t> kNearest(const Point<T,K>& queryPoint, const std::size_t& k,
+        const double& epsilon, std::vector<NodeIndex>& s) const {
+
+        const double shrink = approximation(epsilon);
+
+        // max-heap of squared distance/node pairs, top is the worst of the k best so far
+        std::priority_queue<std::pair<double, NodeIndex>> nearestNeighbors;
+
+        // lambda to offer a node to the k best, evicting the worst when full
+        auto updateNearestNeighbors = [this, &queryPoint, &nearestNeighbors, &k](NodeIndex p) {
+
+            double queryDistance = distance(queryPoint, p, (nearestNeighbors.size() < k) ? std::numeric_limits<double>::max() : nearestNeighbors.top().first);
+
+            if (nearestNeighbors.size() < k) {
+
+                nearestNeighbors.push(std::make_pair(queryDistance, p));
+
+            } else if (queryDistance < nearestNeighbors.top().first) {
+
+                nearestNeighbors.pop();
+                nearestNeighbors.push(std::make_pair(queryDistance, p));
+            }
+        };
+
+        // lambda to bound the search by the k-th nearest neighbor, unbounded until k are found and
+        // shrunk when approximating
+        auto searchRadius = [&nearestNeighbors, &k, &shrink]() {
+            return (nearestNeighbors.size() < k) ? std::numeric_limits<double>::max() : nearestNeighbors.top().first * shrink;
+        };
+
+        std::size_t numnodesvisited = (k > 0) ? searchTree(queryPoint, updateNearestNeighbors, searchRadius, s) : 0;
+
+        // heap pops worst first, fill results from the back to sort by increasing distance
+        std::vector<std::size_t> ids(nearestNeighbors.size());
+        std::vector<double> distances(nearestNeighbors.size());
+
+        for (std::size_t i = nearestNeighbors.size(); i > 0; i--) {
+
+            ids[i - 1] = ids_[nearestNeighbors.top().second];
+            distances[i - 1] = sqrt(nearestNeighbors.top().first);
+            nearestNeighbors.pop();
+        }
+
+        return std::make_tuple(std::move(ids), std::move(distances), numnodesvisited);
+
+    } // end function kNearest
+
+    /*
+     * helper function to query the nearest neighbor of input point best-bin-first
+     * input queryPoint - point to search for nearest neighbor of
+     * input maxChecks - largest number of points whose distance is checked
+     * input bins - scratch heap of unexplored branches, reused across queries on the same thread
+     *
+     * every unexplored branch is kept in a min-heap keyed by a lower bound on the squared distance
+     * of its points, the squared distance to the splitting hyperplane of any ancestor it lies across,
+     * the closest branch is popped and descended to a leaf, queueing the branches passed on the way,
+     * once the closest branch is no closer than the best point found the answer is exact
+     */
+    std::tuple<std::size_t, double, std::size_t, bool> bestBinFirst(const Point<T,K>& queryPoint, const std::size_t& maxChecks,
+        std::vector<std::pair<double, NodeIndex>>& bins) const {
+
+        NodeIndex nearestNeighbor = NIL;
+        double nearestDistance = std::numeric_limits<double>::max();
+        std::size_t numnodesvisited = 0;
+        std::size_t checks = 0;
+
+        // min-heap on the lower bound of each branch
+        std::greater<std::pair<double, NodeIndex>> closer;
+
+        bins.clear();
+        if (root_ != NIL) bins.push_back(std::make_pair(0.0, root_));
+
+        while (!bins.empty() && bins.front().first < nearestDistance && checks < maxChecks) {
+
+            std::pop_heap(bins.begin(), bins.end(), closer);
+            double bound = bins.back().first;
+            NodeIndex current = bins.back().second;
+            bins.pop_back();
+
+            // descend to a leaf on the query point's side, stopping early once out of checks
+            while (current != NIL) {
+
+                const KDNode& node = nodes_[current];
+
+                if (checks + node.count_ > maxChecks) {
+
+                    bins.push_back(std::make_pair(bound, current));
+                    std::push_heap(bins.begin(), bins.end(), closer);
+                    checks = maxChecks;
+                    break;
+                }
+
+                numnodesvisited++;
+                checks += node.count_;
+
+                for (NodeIndex i = node.first_; i < node.first_ + node.count_; i++) {
+
+                    double queryDistance = distance(queryPoint, i, nearestDistance);
 
-    /*
-     * builds kdtree given a list of points
-     * input pointcloud - list of points to put in kdtree
-     * input splitPointStrategy - decision algorithm to find median of input list of points and choose point to split on
-     * input splitAxisStrategy - decision algorithm to find axis to split on
-     */
-    KDTree(PointCloud<T> pointCloud,const SplitPointStrategyPtr splitPointStrategy,const SplitAxisStrategyPtr splitAxisStrategy)
-        : splitPointStrategy_(splitPointStrategy), splitAxisStrategy_(splitAxisStrategy) {
+                    if (queryDistance < nearestDistance) {
 
-        // input points are stored in a pointcloud, however a vector would be more convenient for median finding and processing
-        std::vector<Point<T>> points;
-        points.reserve(pointCloud.points());
-    
-        // http://cpptruths.blogspot.com/2013/10/moving-elements-from-stl-containers-and.html
-        for(const auto& point : pointCloud) {
-           // PointCloud is backed by associative container, must move elements one by one
-           points.push_back(std::move(const_cast<Point<T>&>(point))); // ugly hack
+                        nearestDistance = queryDistance;
+                        nearestNeighbor = i;
+                    }
+                }
+
+                double difference = static_cast<double>(queryPoint[node.dim_]) - static_cast<double>(node.split_);
+                NodeIndex worst = (difference < 0) ? node.right_ : node.left_;
+                double worstBound = std::max(bound, difference * difference);
+
+                // branches already farther than the best point can never improve on it
+                if (worst != NIL && worstBound < nearestDistance) {
+
+                    bins.push_back(std::make_pair(worstBound, worst));
+                    std::push_heap(bins.begin(), bins.end(), closer);
+                }
+
+                current = (difference < 0) ? node.left_ : node.right_;
+            }
         }
-    
-        // build kdtree and assign root
-        BuildKDTree(points);
-    }
 
-    /*  
-     * builds a kdtree from a pcd file
-     */
-    KDTree(PCDFile<T>& pcdfile, const SplitPointStrategyPtr splitPointStrategy,const SplitAxisStrategyPtr splitAxisStrategy) : 
-        KDTree(PointCloud<T>(pcdfile),splitPointStrategy,splitAxisStrategy) {}
+        // exact iff no branch left could hold a closer point
+        bool exact = bins.empty() || bins.front().first >= nearestDistance;
+
+        return std::make_tuple(nodeId(nearestNeighbor), sqrt(nearestDistance), numnodesvisited, exact);
+
+    } // end function bestBinFirst
 
     /*
-     * builds a kdtree from a pcd file with default strategies
+     * helper function to turn an approximation factor into the factor the squared search radius is
+     * shrunk by, a branch is then pruned once its hyperplane distance times (1+epsilon) exceeds the
+     * best distance so every point it could hold is at most (1+epsilon) times closer than the best
      */
-    KDTree(PCDFile<T>& pcdfile) : KDTree(
-        PointCloud<T>(pcdfile),
-        std::make_shared<SplitPointSortStrategy<T>>(),
-        std::make_shared<SplitAxisRoundRobinStrategy<T>>()) {}
+    static double approximation(const double& epsilon) {
+
+        if (!(epsilon >= 0.0)) {
+            throw std::runtime_error("approximation factor epsilon must not be negative");
+        }
+
+        return 1.0 / ((1.0 + epsilon) * (1.0 + epsilon));
+    }
 
     /*
-     * builds a kdtree from an initializer list
+     * scratch state a worker of parallelQuery keeps across its queries, so the queries it runs
+     * allocate nothing once the first few have grown the buffers
      */
-    KDTree(const std::initializer_list<Point<T>>& vals) : 
-        KDTree(vals,std::make_shared<SplitPointSortStrategy<T>>(),std::make_shared<SplitAxisRoundRobinStrategy<T>>()) {} 
+    struct Scratch {
+
+        // traversal stack of the depth first queries
+        std::vector<NodeIndex> stack_;
+
+        // heap of unexplored branches of the best-bin-first query
+        std::vector<std::pair<double, NodeIndex>> bins_;
+    };
 
     /*
-     * builds a kd tree given a graphviz dotfile
-     * input dotfile - handle to filestream containing a serialized pointcloud
+     * helper function to run a query for every input point on a pool of worker threads
+     * input queryPoints - points to query
+     * input threads - number of worker threads, 0 picks one per hardware thread
+     * input query - called with a query point and the worker's scratch state, returns its result
+     * output result of every query, in input order
+     *
+     * the tree is read-only while querying, so workers only share the atomic cursor handing out
+     * chunks of query points and write their results to disjoint slots
      */
-    KDTree(DotFileReader<T>& dotfile) {
-
-        // get root from dot file
-        auto it = dotfile.begin();
-        root = buildNode(*it);
+    template <typename Result, typename Query>
+    std::vector<Result> parallelQuery(const std::vector<Point<T,K>>& queryPoints, const std::size_t& threads, Query query) const {
 
-        // enqueue root
-        std::queue<KDNodePtr> q;
-        if (root) q.push(root);
+        // queries are handed out in chunks so workers don't contend on the cursor for every point
+        const static std::size_t CHUNK = 256;
 
-        // build kdtree in level-order
-        while(!q.empty()) {
-       
-            // current node
-            KDNodePtr temp = q.front();
-            q.pop();
+        std::vector<Result> results(queryPoints.size());
+        std::atomic<std::size_t> cursor(0);
 
-            // children nodes
-            temp->left_ = buildNode(*++it);
-            temp->right_ = buildNode(*++it);
+        ThreadPool pool(threads);
+        std::vector<std::future<void>> workers;
 
-            // enqueue children
-            if (temp->left_) q.push(temp->left_);
-            if (temp->right_) q.push(temp->right_);
-        }        
-    }
+        for (std::size_t i = 0; i < pool.threads(); i++) {
 
-    // don't allow copying a kdtree to a new instance (well there is still a sneaky way to do it...)
-    // kdtrees could potentially be huge, one is enough... until the design review
-    KDTree(KDTree& other) = delete;
+            workers.push_back(pool.submit([this, &queryPoints, &query, &results, &cursor]() {
 
-    /*
-     * move a kdtree instance
-     */
-    KDTree(KDTree&& other) {
-   
-       // moving shared pointers will not effect internal reference counters 
-       // other's shared pointers will now all be null
-       this->root = std::move(other.root);
-       // TODO: move strategies as well
-    }
+                // per worker scratch state, sized for one descent, the buffers keep whatever a larger query grew them to
+                Scratch scratch;
+                scratch.stack_.reserve(height_ + 1);
+                scratch.bins_.reserve(height_ + 1);
 
-    /**
-     * begin iterator to walk tree in level order
-     */
-    auto begin() {
+                for (std::size_t begin = cursor.fetch_add(CHUNK); begin < queryPoints.size(); begin = cursor.fetch_add(CHUNK)) {
 
-        KDNodePtr temp = root;
-        
-        
-        return LevelorderIterator<std::pair<Point<T>,int>>(temp);
-    }
+                    std::size_t end = std::min(begin + CHUNK, queryPoints.size());
 
-    auto begin() const {
-        
-        KDNodePtr temp = root;
-        return LevelorderIterator<std::pair<Point<T>,int>>(temp);
-    }
+                    for (std::size_t i = begin; i < end; i++) {
+                        results[i] = query(queryPoints[i], scratch);
+                    }
+                }
+            }));
+        }
 
-    /**
-     * end iterator to signify all nodes in kdtree have been visited
-     */
-    auto end() {return LevelorderIterator<std::pair<Point<T>,int>>();}
+        // wait for every worker, rethrows the first exception a worker hit
+        for (std::future<void>& worker : workers) {
+            worker.get();
+        }
 
-    auto end() const {return LevelorderIterator<std::pair<Point<T>,int>>();}
+        return results;
+    }
 
     /*
-     * queries tree for nearest neighbor of input point
-     * input queryPoint - point to search for nearest neighbor of
-     * output Point - point in kdtree that is closest to input point
+     * helper function shared by the queries to walk the tree for points near a query point
+     * input queryPoint - point to search around
+     * input visit - called with the index of every point in a node that is not pruned
+     * input searchRadius - returns the current squared distance bound, a branch whose splitting
+     *  hyperplane lies further than this from the query point is pruned
+     * input s - scratch stack for the traversal, cleared before use
+     * input stats - optional, set to the work done by the traversal, only compiled in when
+     *  QUERY_STATS_ENABLED so the counters cost nothing otherwise
+     * output number of nodes visited
      *
      * this function works by iteratively performing a "modified" inorder dfs
      * the modification is that normally inorder searches leftChild->parent->rightChild
@@ -171,269 +1627,479 @@ class KDTree {
      * then we search parent, and finally we either skip "least likely child" and in effect
      * "prune" the tree, or search "least likely child" (if heuristic is met)
      */
-    std::tuple<Point<T>, double, std::size_t> queryNearestNeighbor(const Point<T>& queryPoint) const {
+    template <typename Visit, typename SearchRadius>
+    std::size_t searchTree(const Point<T,K>& queryPoint, Visit& visit, SearchRadius& searchRadius, std::vector<NodeIndex>& s,
+        QueryStats* stats = nullptr) const {
 
-        // initialize nearest neighbor/distance as empty point at distance infinity
-        Point<T> nearestNeighbor = Point<T>();
-        double nearestDistance = std::numeric_limits<double>::max();
         std::size_t numnodesvisited = 0;
 
         // state variables for iterative "modified" inorder traversal
-        auto current = root;
-        std::stack<KDNodePtr> s;
+        NodeIndex current = root_;
+        s.clear();
+
+        if constexpr (QUERY_STATS_ENABLED) {
+            if (stats) *stats = QueryStats();
+        }
 
         // lambda to explore the next node that lies on the same side of the axis as the query point
-        auto traverseBestPath = [&queryPoint](KDNodePtr p) {   
-            return ((queryPoint[p->dim_] < p->point_[p->dim_]) ? p->left_ : p->right_);
-        };  
+        auto traverseBestPath = [this, &queryPoint](NodeIndex p) {
+            const KDNode& node = nodes_[p];
+            return ((queryPoint[node.dim_] < node.split_) ? node.left_ : node.right_);
+        };
 
         // lambda to explore the next node that lies on the opposite side of the axis as the query point
-        auto traverseWorstPath = [&queryPoint](KDNodePtr p) {
-            return ((queryPoint[p->dim_] < p->point_[p->dim_]) ? p->right_ : p->left_);
-        };  
+        auto traverseWorstPath = [this, &queryPoint](NodeIndex p) {
+            const KDNode& node = nodes_[p];
+            return ((queryPoint[node.dim_] < node.split_) ? node.right_ : node.left_);
+        };
 
         // lambda to decide to prune tree branch iff the hypersphere around the query point intersects the axis hyperplane!!
-        auto pruneTree = [&queryPoint, &nearestNeighbor, &nearestDistance](const KDNodePtr p) {
-            return (std::norm(queryPoint[p->dim_] - p->point_[p->dim_]) > nearestDistance) ? true : false;
-        };  
-
-        // lambda to update nearest neighbor
-        auto updateNearestNeighbor = [&queryPoint, &nearestNeighbor, &nearestDistance](const Point<T> p) {
- 
-            double queryDistance = std::norm(queryPoint - p);
-            
-            if(queryDistance < nearestDistance) {
-                
-                nearestDistance = queryDistance;
-                nearestNeighbor = p;
-            }
-        };  
+        auto pruneTree = [this, &queryPoint, &searchRadius](NodeIndex p) {
+            const KDNode& node = nodes_[p];
+            return (std::norm(queryPoint[node.dim_] - node.split_) > searchRadius()) ? true : false;
+        };
 
         // push current node on stack and traverse best path
-        if (current) {
+        if (current != NIL) {
 
-            s.push(current);
+            s.push_back(current);
             current = traverseBestPath(current);
+
+            if constexpr (QUERY_STATS_ENABLED) {
+                if (stats) stats->maxStackDepth_ = 1;
+            }
         }
 
         while (!s.empty()) { // explore every non-pruned node in tree
 
-            if (current) { // continue exploring "best" child
-   
+            if (current != NIL) { // continue exploring "best" child
+
                 // push current node on stack and traverse "best" path
-                s.push(current);
+                s.push_back(current);
                 current = traverseBestPath(current);
-    
+
+                if constexpr (QUERY_STATS_ENABLED) {
+                    if (stats) stats->maxStackDepth_ = std::max(stats->maxStackDepth_, s.size());
+                }
+
             } else { // reached a leaf, unwind stack
 
                 // visit node
-                KDNodePtr temp = s.top();
-                s.pop();
+                NodeIndex temp = s.back();
+                s.pop_back();
                 numnodesvisited++;
 
-                // check if we found a new nearest neighbor, hope to check only O(lgn) times
-                updateNearestNeighbor(temp->point_);
+                // check if the node's points are new candidates, hope to check only O(lgn) times,
+                // a bucket's points are contiguous so this is a linear scan of its coordinates
+                const KDNode& node = nodes_[temp];
+
+                for (NodeIndex i = node.first_; i < node.first_ + node.count_; i++) visit(i);
+
+                if constexpr (QUERY_STATS_ENABLED) {
+                    if (stats) {
+
+                        stats->nodesVisited_++;
+                        stats->distanceEvaluations_ += node.count_;
+                        stats->leavesScanned_ += (node.left_ == NIL && node.right_ == NIL) ? 1 : 0;
+
+                        // a missing far child is neither pruned nor descended
+                        if (traverseWorstPath(temp) != NIL) (pruneTree(temp) ? stats->branchesPruned_ : stats->branchesDescended_)++;
+                    }
+                }
 
                 // optimization: try to save a lot of time by pruning tree and not exploring other child
-                if(!pruneTree(temp) && (temp = traverseWorstPath(temp))) {
-      
-                    s.push(temp);
+                if(!pruneTree(temp) && ((temp = traverseWorstPath(temp)) != NIL)) {
+
+                    s.push_back(temp);
                     current = traverseBestPath(temp);
+
+                    if constexpr (QUERY_STATS_ENABLED) {
+                        if (stats) stats->maxStackDepth_ = std::max(stats->maxStackDepth_, s.size());
+                    }
                 } // end if
             } // end else
         } // end while
 
-        return std::make_tuple(std::move(nearestNeighbor), sqrt(nearestDistance), numnodesvisited);
+        return numnodesvisited;
 
-    } // end function queryNearestNeighbor
+    } // end function searchTree
 
     /*
-     * compares two kdtrees for inequality
+     * helper function to recursively collect the points of a subtree inside a box
+     * input box - box to search
+     * input p - root of the subtree
+     * input first - index of the first point of the subtree
+     * input last - index of the last point of the subtree
+     * input cell - cell holding every point of the subtree, narrowed for the children and restored before returning
+     * input indices - collects the index of every point found
+     * input numnodesvisited - incremented for every node visited
      */
-    bool operator!=(const KDTree& other) const {
+    void searchBox(const Cell<T,K>& box, NodeIndex p, NodeIndex first, NodeIndex last, Cell<T,K>& cell,
+        std::vector<std::size_t>& indices, std::size_t& numnodesvisited) const {
 
-        return !(this->operator==(other));
+        // whole subtree misses the box
+        if (!box.intersects(cell)) return;
+
+        // whole subtree inside the box, report its contiguous range without testing any point
+        if (box.contains(cell)) {
+
+            for (std::size_t index = first; index <= last; index++) indices.push_back(index);
+            return;
+        }
+
+        // check the points at this node
+        numnodesvisited++;
+
+        const KDNode& node = nodes_[p];
+
+        for (std::size_t index = node.first_; index < node.first_ + node.count_; index++) {
+
+            auto coordinate = coordinates_.begin() + index * dims();
+            bool inside = true;
+
+            for (std::size_t i = 0; i < dims() && inside; i++) {
+                inside = !(coordinate[i] < box.min()[i] || box.max()[i] < coordinate[i]);
+            }
+
+            if (inside) indices.push_back(index);
+        }
+
+        // children cover the part of the cell on either side of the splitting hyperplane
+        if (node.left_ != NIL) {
+
+            T upper = cell.max()[node.dim_];
+            cell.max()[node.dim_] = node.split_;
+            searchBox(box, node.left_, first, node.first_ - 1, cell, indices, numnodesvisited);
+            cell.max()[node.dim_] = upper;
+        }
+
+        if (node.right_ != NIL) {
+
+            T lower = cell.min()[node.dim_];
+            cell.min()[node.dim_] = node.split_;
+            searchBox(box, node.right_, node.first_ + 1, last, cell, indices, numnodesvisited);
+            cell.min()[node.dim_] = lower;
+        }
     }
 
     /*
-     * compares two kdtrees for equality
+     * helper function to move points into inorder, used after nodes were appended in another order,
+     * nodes stay where they are and are pointed at their point's new index
      */
-    bool operator==(const KDTree& other) const {
-    
-        // roots of trees
-        KDNodePtr rootA = this->root;
-        KDNodePtr rootB = other.root;
+    void relayout() {
 
-        // enqueue both trees
-        std::queue<KDNodePtr> qA;
-        std::queue<KDNodePtr> qB;
+        if (root_ == NIL) return;
 
-        if (rootA) qA.push(rootA);
-        if (rootB) qB.push(rootB);
+        // inorder position of every node
+        std::vector<NodeIndex> order;
+        std::vector<NodeIndex> position(nodes_.size());
+        order.reserve(nodes_.size());
 
-        // iterate through trees in level order
-        while (!qA.empty() && !qB.empty()) {
+        std::stack<NodeIndex> s;
+        NodeIndex current = root_;
 
-            // examine nodes in level order
-            KDNodePtr tempA = qA.front();
-            KDNodePtr tempB = qB.front();
-            qA.pop();
-            qB.pop();
+        while (current != NIL || !s.empty()) {
 
-            // check for equality
-            if ((tempA->point_ != tempB->point_) || (tempA->dim_ != tempB->dim_)) { 
-                return false;
+            if (current != NIL) {
+
+                s.push(current);
+                current = nodes_[current].left_;
+
+            } else {
+
+                current = s.top();
+                s.pop();
+                position[current] = order.size();
+                order.push_back(current);
+                current = nodes_[current].right_;
             }
+        }
 
-            if (!tempA->left_ && tempB->left_) return false;
-            if (!tempB->right_ && tempB->right_) return false;
+        // rebuild the point arrays in inorder
+        std::vector<T> coordinates(coordinates_.size());
+        std::vector<std::uint64_t> ids(ids_.size());
 
-            // enqueue nodes
-            if (tempA->left_) qA.push(tempA->left_);
-            if (tempA->right_) qA.push(tempA->right_);
-            if (tempB->left_) qB.push(tempB->left_);
-            if (tempB->right_) qB.push(tempB->right_);
+        for (std::size_t i = 0; i < order.size(); i++) {
+
+            nodes_[order[i]].first_ = i;
+
+            std::copy(coordinates_.begin() + order[i] * dims_, coordinates_.begin() + (order[i] + 1) * dims_, coordinates.begin() + i * dims_);
+            ids[i] = ids_[order[i]];
         }
 
-        // make sure both trees are same length
-        return (qA.empty() != qB.empty()) ? false : true;
+        coordinates_ = std::move(coordinates);
+        ids_ = std::move(ids);
     }
 
-    private:
+    /*
+     * helper function to move the nodes reachable from the root into preorder with children
+     * renumbered, dropping unused slots left by the build, and measure the height of the tree
+     */
+    void compact() {
+
+        std::vector<KDNode> nodes;
+        height_ = 0;
+
+        if (root_ == NIL) {
+
+            nodes_ = std::move(nodes);
+            return;
+        }
+
+        // pending nodes with their parent's new index and their depth, right children are pushed
+        // first so a left subtree is laid out before its sibling
+        std::stack<std::tuple<NodeIndex, NodeIndex, bool, std::size_t>> s;
+        s.push(std::make_tuple(root_, NIL, true, 1));
+
+        while (!s.empty()) {
+
+            NodeIndex current, parent;
+            bool left;
+            std::size_t depth;
+            std::tie(current, parent, left, depth) = s.top();
+            s.pop();
+
+            height_ = std::max(height_, depth);
+
+            NodeIndex index = nodes.size();
+            nodes.push_back(nodes_[current]);
+
+            if (parent == NIL) root_ = index;
+            else if (left) nodes[parent].left_ = index;
+            else nodes[parent].right_ = index;
+
+            if (nodes[index].right_ != NIL) s.push(std::make_tuple(nodes[index].right_, index, false, depth + 1));
+            if (nodes[index].left_ != NIL) s.push(std::make_tuple(nodes[index].left_, index, true, depth + 1));
+        }
+
+        nodes_ = std::move(nodes);
+    }
 
     /*
-     * helper function to construct kd tree given a list of points
-     * input points - list of points to move into kdtree
+     * helper function to compute the smallest cell containing every point
      */
-    void BuildKDTree(std::vector<Point<T>>& points) {
-        
-        // magic numbers used in this method for tuple access
-        const static std::size_t NODE = 0;
-        const static std::size_t START = 1;
-        const static std::size_t STOP = 2;
+    void computeBounds() {
 
-        // maintain stack inputs to build tree in preorder manner
-        std::queue<std::tuple<KDNodePtr, int, int>> q;
+        bounds_ = Cell<T,K>(dims());
 
-        // build root node
-        int start = 0;
-        int stop = points.size() - 1;
-        KDNodePtr temp = root = buildNode(points,start,stop);
+        if (points_ == 0) return;
 
-        if (root) q.push(std::make_tuple(root,start,stop));
+        for (std::size_t i = 0; i < dims(); i++) {
 
-        while(!q.empty()) { // iterate until every input point is processed
-          
-            // extract data from queue
-            temp = std::get<NODE>(q.front());
-            start = std::get<START>(q.front());
-            stop = std::get<STOP>(q.front());
-            q.pop();
-            
-            // build child nodes
-            int mid = std::ceil((start + stop)/2.0);
-            temp->left_ = buildNode(points, start, mid - 1);
-            temp->right_ = buildNode(points, mid + 1, stop);
-            // push data onto "stack"
-            if (temp->left_) q.push(std::make_tuple(temp->left_, start, mid - 1));
-            if (temp->right_) q.push(std::make_tuple(temp->right_, mid + 1, stop));
+            bounds_.min()[i] = std::numeric_limits<T>::max();
+            bounds_.max()[i] = std::numeric_limits<T>::lowest();
         }
-    } 
+
+        for (std::size_t p = 0; p < points_; p++) {
+
+            for (std::size_t i = 0; i < dims(); i++) {
+
+                bounds_.min()[i] = std::min(bounds_.min()[i], coordinates_[p * dims() + i]);
+                bounds_.max()[i] = std::max(bounds_.max()[i], coordinates_[p * dims() + i]);
+            }
+        }
+    }
 
     /*
-     * helper nested class - node to store data in KDTree
+     * helper function to compute squared euclidean distance between a point and a node, reads the
+     * node coordinates in place rather than building a temporary point
+     * input bound - the distance may stop being summed once it exceeds bound, see DistanceKernel
      */
-    class KDNode {
+    double distance(const Point<T,K>& queryPoint, NodeIndex p, const double& bound = std::numeric_limits<double>::max()) const {
 
-        friend class KDTree;
+        return DistanceKernel<T>::squaredDistance(queryPoint.data(), coordinates_.begin() + p * dims(), dims(), bound);
+    }
+
+    /*
+     * helper function to materialize the point stored at a node, empty point for a missing node
+     * N selects a fixed or runtime dimensioned result, the level order iterator always uses 0
+     */
+    template <std::size_t N = K>
+    Point<T,N> nodePoint(NodeIndex p) const {
+
+        if (p == NIL) return Point<T,N>();
+
+        Point<T,N> result(dims_);
+        std::copy(coordinates_.begin() + p * dims_, coordinates_.begin() + (p + 1) * dims_, result.begin());
+        result.id(ids_[p]);
+
+        return result;
+    }
+
+    /*
+     * helper function to look up the id of the point stored at a node, Point::NO_ID for a missing node
+     */
+    std::size_t nodeId(NodeIndex p) const {
+
+        return (p == NIL) ? Point<T,K>::NO_ID : ids_[p];
+    }
+
+    /*
+     * strategy to determine median of input points for insertion
+     */
+    const SplitPointStrategyPtr splitPointStrategy_;
+
+    /*
+     * strategy to determine axis of input points for insertion
+     */
+    const SplitAxisStrategyPtr splitAxisStrategy_;
+
+    /*
+     * helper nested class - array either owned by the tree or viewing memory owned elsewhere, such
+     * as a mapped file, queries only ever read through data_
+     */
+    template <typename E>
+    class Storage {
 
         public:
 
-        /*
-         * build node
-         * input point - k dimensional point to store in node
-         * input dim - dimension to consider splitting on for children of this node
-         */
-        KDNode(Point<T> point, std::size_t dim) :
-            point_(point), dim_(dim), left_(nullptr), right_(nullptr) {}
+        Storage() : data_(nullptr), size_(0) {}
+
+        Storage(Storage& other) = delete;
+
+        Storage(Storage&& other) {*this = std::move(other);}
 
         /*
-         * streams a kdnode in format point@dimension
-         * input ss - ostream to output serialized node
+         * take over other's elements, other is left empty
          */
-        friend std::ostream& operator<<(std::ostream& ss, const KDNodePtr kdnode) {
-   
-            // serialize kdnode into stream
-            ss << kdnode->point_;
-            ss << "@";
-            ss << kdnode->dim_;
+        Storage& operator=(Storage&& other) {
 
-            return ss;
-        }
+            owned_ = std::move(other.owned_);
+            data_ = other.data_;
+            size_ = other.size_;
 
-        private:
+            other.owned_.clear();
+            other.data_ = nullptr;
+            other.size_ = 0;
+
+            return *this;
+        }
 
         /*
-         * left child, less than parent node @dim
+         * take ownership of the elements of a vector
          */
-        std::shared_ptr<KDNode> left_;
+        Storage& operator=(std::vector<E>&& elements) {
+
+            owned_ = std::move(elements);
+            sync();
+
+            return *this;
+        }
 
         /*
-         * right child, greater than parent node @dim
+         * view size elements starting at data, the memory must outlive this storage
          */
-        std::shared_ptr<KDNode> right_;
+        void view(const E* data, const std::size_t& size) {
+
+            owned_ = std::vector<E>();
+            data_ = data;
+            size_ = size;
+        }
 
         /*
-         * k dimensional point stored at this node
+         * resize owned elements, only valid while building
          */
-        Point<T> point_;
+        void resize(const std::size_t& size) {
+
+            owned_.resize(size);
+            sync();
+        }
 
         /*
-         * dimension to compare left/right child points to
+         * append to owned elements, only valid while building
          */
-        std::size_t dim_;
+        void push_back(const E& element) {
+
+            owned_.push_back(element);
+            sync();
+        }
+
+        template <typename Iterator>
+        void append(Iterator first, Iterator last) {
+
+            owned_.insert(owned_.end(), first, last);
+            sync();
+        }
+
+        const E& operator[](const std::size_t& i) const {return data_[i];}
+
+        // only valid while building, when the elements are owned
+        E& operator[](const std::size_t& i) {return owned_[i];}
+
+        const E* begin() const {return data_;}
+
+        const E* end() const {return data_ + size_;}
 
-    }; // class KDNode
+        std::size_t size() const {return size_;}
+
+        bool empty() const {return size_ == 0;}
+
+        // bytes of the elements, including spare capacity of owned elements
+        std::size_t bytes() const {return std::max(owned_.capacity(), size_) * sizeof(E);}
+
+        private:
+
+        void sync() {
+
+            data_ = owned_.data();
+            size_ = owned_.size();
+        }
+
+        std::vector<E> owned_;
+        const E* data_;
+        std::size_t size_;
+
+    }; // class Storage
 
     /*
-     *  helper function to build node (used for in-memory pointcloud container)
-     *  input points - point vector to be move into tree
-     *  input start - inclusive index of point vector to start selection of split point/axis
-     *  input stop - inclusive index of point vector to stop selection of split point/axis
+     * nodes of kdtree in preorder, children are referenced by index into this array
      */
-    KDNodePtr buildNode(std::vector<Point<T>>& points, const int& start, const int& stop) {
-        
-        // base case, we have passed a leaf
-        if (start > stop) return nullptr;
+    Storage<KDNode> nodes_;
 
-        // decide axis and point to split on
-        int splitAxis = splitAxisStrategy_->splitAxis(points, start, stop); 
-        Point<T> splitPoint = splitPointStrategy_->splitPoint(points, splitAxis, start, stop);
-        return std::make_shared<KDNode>(std::move(splitPoint), splitAxis);
-    }
+    /*
+     * dense coordinates of every point in inorder, dims_ values per point
+     */
+    Storage<T> coordinates_;
 
     /*
-     * helper function to build node (used for dot file deserialization)
-     * input p - point/dimension to be moved into node
+     * id of every point in inorder
      */
-    KDNodePtr buildNode(const PointDimPair& p) {
-        return (p.first == Point<T>()) ? nullptr : std::make_shared<KDNode>(std::move(p.first),p.second);
-    }
+    Storage<std::uint64_t> ids_;
 
     /*
-     * strategy to determine median of input points for insertion
+     * keeps the binary kdtree file the arrays point into mapped, null when the arrays are owned
      */
-    const SplitPointStrategyPtr splitPointStrategy_;
+    std::shared_ptr<const void> mapping_;
 
     /*
-     * strategy to determine axis of input points for insertion
+     * smallest cell containing every point
      */
-    const SplitAxisStrategyPtr splitAxisStrategy_;
+    Cell<T,K> bounds_;
+
+    /*
+     * dimensionality of points stored in kdtree
+     */
+    std::size_t dims_;
+
+    /*
+     * number of points stored in kdtree
+     */
+    std::size_t points_;
 
     /*
      * root of kdtree
      */
-    KDNodePtr root;
+    NodeIndex root_;
+
+    /*
+     * largest number of points stored in one leaf
+     */
+    std::size_t bucketSize_;
+
+    /*
+     * number of nodes on the longest path from the root to a leaf
+     */
+    std::size_t height_;
 
     /*
      * nested iterator class to walk kdtree nodes in level order
@@ -446,13 +2112,14 @@ class KDTree {
         /**
          * returns empty iterator signaling end iterator
          */ 
-        LevelorderIterator() {}
+        LevelorderIterator() : kdtree_(nullptr) {}
 
         /*
          * returns initialized values in iterator signaling begin iterator
+         * input kdtree - tree owning the nodes
          * input root - node to begin preorder traversal
          */
-        LevelorderIterator(KDNodePtr root) {
+        LevelorderIterator(const KDTree* kdtree, NodeIndex root) : kdtree_(kdtree) {
  
             // initialize iteration
             q_.push(root);
@@ -470,12 +2137,12 @@ class KDTree {
 
             if (!q_.empty()) {
             
-                KDNodePtr temp = q_.front();
+                NodeIndex temp = q_.front();
                 q_.pop();
  
-                if (temp) q_.push(temp->left_);
-                if (temp) q_.push(temp->right_);
-                pointDimPair_ = temp ? std::make_pair(temp->point_, temp->dim_) : std::make_pair(Point<T>(), std::size_t(0));
+                if (temp != NIL) q_.push(kdtree_->nodes_[temp].left_);
+                if (temp != NIL) q_.push(kdtree_->nodes_[temp].right_);
+                pointDimPair_ = (temp != NIL) ? std::make_pair(kdtree_->template nodePoint<0>(kdtree_->nodes_[temp].first_), kdtree_->nodes_[temp].dim_) : std::make_pair(Point<T>(), std::uint32_t(0));
             }            
 
             return *this;
@@ -488,7 +2155,8 @@ class KDTree {
 
         private:
    
-        std::queue<KDNodePtr> q_;
+        const KDTree* kdtree_;
+        std::queue<NodeIndex> q_;
         PointDimPair pointDimPair_;
         int prevSize = 0;
         
@@ -496,6 +2164,9 @@ class KDTree {
 
 }; // class KDTree
 
+template<typename T, std::size_t K>
+const typename KDTree<T,K>::NodeIndex KDTree<T,K>::NIL;
+
 } // namespace rossb83
 
 #endif
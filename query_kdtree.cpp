@@ -1,7 +1,12 @@
+#include <chrono>
+
+// traversals only record their work for -stats when built with -DROSSB83_QUERY_STATS, as make does for query_kdtree_stats
 #include "Point.hpp"
 #include "kdtree.hpp"
 #include "DotFileWriter.hpp"
+#include "BinaryFileReader.hpp"
 #include "PCDFile.hpp"
+#include "LabelTable.hpp"
 
 using namespace rossb83;
 
@@ -13,9 +18,15 @@ int main(int argc, char* argv[]) {
     static const std::string KDTREE_FILE = "kdtreefile";
     static const std::string QUERY_FILE = "queryfile";
     static const std::string OUTPUT_FILE = "outputfile";
+    static const std::string NEIGHBORS = "k";
+    static const std::string THREADS = "threads";
+    static const std::string EPSILON = "epsilon";
+    static const std::string CHECKS = "checks";
+    static const std::string LABEL_FILE = "labelfile";
+    static const std::string STATS_FILE = "stats";
 
     std::unordered_map<std::string,std::string> inputs;
-    inputs.insert({{KDTREE_FILE,"sample_kdtree.dot"},{QUERY_FILE,"query_data.csv"},{OUTPUT_FILE,"sample_query.csv"}});
+    inputs.insert({{KDTREE_FILE,"sample_kdtree.dot"},{QUERY_FILE,"query_data.csv"},{OUTPUT_FILE,"sample_query.csv"},{NEIGHBORS,"1"},{THREADS,"1"},{EPSILON,"0"},{CHECKS,"0"},{LABEL_FILE,""},{STATS_FILE,""}});
 
     for (size_t i = 1; i < argc; i++) {
 
@@ -28,6 +39,47 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // number of nearest neighbors to output per query point
+    std::size_t k = std::stoul(inputs[NEIGHBORS]);
+
+    // number of worker threads to split the queries across
+    std::size_t threads = std::stoul(inputs[THREADS]);
+
+    // approximation factor, neighbors may be up to (1+epsilon) times farther than the true ones
+    double epsilon = std::stod(inputs[EPSILON]);
+
+    // largest number of points checked per query by a best-bin-first search, 0 searches exhaustively
+    std::size_t checks = std::stoul(inputs[CHECKS]);
+
+    // a best-bin-first search finds a single neighbor and bounds its work by checks rather than epsilon
+    if (checks > 0 && k != 1) {
+
+        std::cerr << "-checks only supports -k=1" << std::endl;
+        return 1;
+    }
+
+    if (checks > 0 && epsilon > 0) {
+
+        std::cerr << "-checks and -epsilon can't be combined" << std::endl;
+        return 1;
+    }
+
+    // statistics time every query on its own and only nearest neighbor queries record their traversal
+    if (!inputs[STATS_FILE].empty()) {
+
+        if (!QUERY_STATS_ENABLED) {
+
+            std::cerr << "-stats needs query statistics compiled in, build query_kdtree_stats" << std::endl;
+            return 1;
+        }
+
+        if (k != 1 || checks > 0 || threads != 1) {
+
+            std::cerr << "-stats only supports -k=1 -checks=0 -threads=1" << std::endl;
+            return 1;
+        }
+    }
+
     std::cout << "Reading query data input file: " << inputs[QUERY_FILE] << std::endl;
 
     // read input file from disk
@@ -35,19 +87,112 @@ int main(int argc, char* argv[]) {
 
     std::cout << "Deserializing kdtree file: " << inputs[KDTREE_FILE] << std::endl;
     
+    // binary kdtree files are mapped and queried in place, dot files are parsed
+    auto readKDTree = [](const std::string& filename) {
+
+        if (BinaryFileReader<double>::isBinaryFile(filename)) {
+
+            BinaryFileReader<double> binaryfile(filename);
+            return KDTree<double>(binaryfile);
+        }
+
+        DotFileReader<double> dotfile(filename);
+        return KDTree<double>(dotfile);
+    };
+
     // generate kdtree from input file
-    DotFileReader<double> dotfile(inputs[KDTREE_FILE]);
-    KDTree<double> kdtree(dotfile);
+    KDTree<double> kdtree = readKDTree(inputs[KDTREE_FILE]);
+
+    // neighbors are written as the ids stored in the tree unless a label file names them
+    LabelTable labels;
+
+    if (!inputs[LABEL_FILE].empty()) {
+
+        std::cout << "Reading label file: " << inputs[LABEL_FILE] << std::endl;
+        labels = LabelTable(inputs[LABEL_FILE]);
+    }
+
+    auto name = [&labels](const std::size_t& id) {
+        return (labels.size() > 0) ? labels.label(id) : std::to_string(id);
+    };
 
     // create output file
     std::cout << "creating output file: " << inputs[OUTPUT_FILE] << std::endl;
     std::ofstream out(inputs[OUTPUT_FILE]);
 
+    // read every query point up front so they can be handed out to the workers
+    std::vector<Point<double>> queryPoints;
+    queryPoints.reserve(queryfile.points());
+
     for (Point<double> p : queryfile) {
+        queryPoints.push_back(std::move(p));
+    }
+
+    std::cout << "Querying kdtree with " << threads << " thread(s)" << std::endl;
+
+    if (kdtree.points() == 0) {
+
+        // an empty tree has no neighbors to name, every query gets an empty line
+        std::cout << "kdtree is empty, no query has a neighbor" << std::endl;
+
+        for (std::size_t i = 0; i < queryPoints.size(); i++) out << '\n';
+
+        if (!inputs[STATS_FILE].empty()) QueryStatistics().writeFile(inputs[STATS_FILE]);
+
+    } else if (!inputs[STATS_FILE].empty()) {
+
+        // the queries written are the ones measured, one at a time through a context that records their traversal
+        KDTree<double>::QueryContext context(kdtree);
+        QueryStatistics statistics;
+
+        for (const Point<double>& queryPoint : queryPoints) {
+
+            auto start = std::chrono::steady_clock::now();
+            std::pair<std::size_t, double> nearestneighbor = kdtree.queryNearestNeighbor(queryPoint, context, epsilon);
+            auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+            statistics.add(context.stats(), latency);
+
+            out << name(kdtree.id(nearestneighbor.first)) << "," << std::sqrt(nearestneighbor.second) << '\n';
+        }
+
+        std::cout << "Writing query statistics file: " << inputs[STATS_FILE] << std::endl;
+        statistics.writeFile(inputs[STATS_FILE]);
+
+    } else if (k == 1 && checks > 0) {
 
-        // returns tuple where 1st element is the nearest neighbor, 2nd is the euclidean distance, and 3rd is the number of nodes in the tree visited
-        std::tuple<Point<double>, double, int> nearestneighbor = kdtree.queryNearestNeighbor(p);
-        out << std::get<0>(nearestneighbor).label() << "," << std::get<1>(nearestneighbor) << std::endl;
+        // each tuple holds the nearest neighbor found, the euclidean distance, the number of nodes in the tree visited and whether it is exact
+        std::vector<std::tuple<std::size_t, double, std::size_t, bool>> nearestneighbors = kdtree.queryBestBinFirst(queryPoints, checks, threads);
+
+        for (const auto& nearestneighbor : nearestneighbors) {
+
+            out << name(std::get<0>(nearestneighbor)) << "," << std::get<1>(nearestneighbor) << '\n';
+        }
+
+    } else if (k == 1) {
+
+        // each tuple holds the nearest neighbor, the euclidean distance, and the number of nodes in the tree visited
+        std::vector<std::tuple<std::size_t, double, std::size_t>> nearestneighbors = kdtree.queryNearestNeighbor(queryPoints, threads, epsilon);
+
+        for (const auto& nearestneighbor : nearestneighbors) {
+
+            out << name(std::get<0>(nearestneighbor)) << "," << std::get<1>(nearestneighbor) << '\n';
+        }
+
+    } else {
+
+        // each tuple holds the k nearest neighbors, their euclidean distances, and the number of nodes in the tree visited
+        std::vector<std::tuple<std::vector<std::size_t>, std::vector<double>, std::size_t>> nearestneighbors = kdtree.queryKNearest(queryPoints, k, threads, epsilon);
+
+        for (const auto& nearestneighbor : nearestneighbors) {
+
+            for (std::size_t i = 0; i < std::get<0>(nearestneighbor).size(); i++) {
+
+                out << ((i > 0) ? "," : "") << name(std::get<0>(nearestneighbor)[i]) << "," << std::get<1>(nearestneighbor)[i];
+            }
+
+            out << '\n';
+        }
     }
 
     return 0;
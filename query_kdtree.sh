@@ -1,8 +1,17 @@
 #!/bin/sh
 
 # this will build a kdtree from an input point cloud file
-# -kdtreefile=sample_kdtree.dot input serialized kdtree file
+# -kdtreefile=sample_kdtree.dot input serialized kdtree file, either a dot file or a binary file written with -format=binary
 # -outputfile=sample_query.csv output file to store query data
 # -queryfile=query_data.csv data to query kdtree with
+# -k=1 number of nearest neighbors to output per query, each line holds k id,distance pairs, and is empty when the kdtree is
+# -threads=1 number of worker threads to split the queries across, 0 uses every hardware thread
+# -epsilon=0 approximation factor, neighbors may be up to (1+epsilon) times farther than the true ones in exchange for visiting fewer nodes
+# -checks=0 largest number of points checked per query with k=1, searching the closest branches first, 0 searches exhaustively,
+#  it can't be combined with -k>1 or -epsilon
+# -labelfile= optional file with one label per line, neighbors are written as the label on the line of their id instead of the id
+# -stats= optional file to write histograms of latency and traversal work of each nearest neighbor query to, csv if it ends in .csv and json otherwise,
+#  only query_kdtree_stats (built by make with -DROSSB83_QUERY_STATS) records the work, and only with -k=1 -checks=0 -threads=1 so
+#  every query written is timed on its own
 
 ./query_kdtree -kdtreefile=sample_kdtree.dot -queryfile=query_data.csv -outputfile=sample_query.csv